@@ -0,0 +1,419 @@
+/*
+MIT License
+
+Copyright (c) 2019 Reep Softworks
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#include <vector>
+#include <string>
+#include "rinput.h"
+#include "context.h"
+
+namespace RInput
+{
+	#define COMBO_DIR_UP 1
+	#define COMBO_DIR_DOWN 2
+	#define COMBO_DIR_LEFT 4
+	#define COMBO_DIR_RIGHT 8
+
+	//-----------------------------------------------------------------------------
+	// Purpose: Does an input satisfy a step?
+	//-----------------------------------------------------------------------------
+	bool _ComboStepMatches(const combonode_t& pNode, const comboinput_t& pInput)
+	{
+		if (pNode.type == COMBO_STEP_DIRECTION)
+		{
+			return pInput.type == COMBO_INPUT_DIRECTION && pInput.code == pNode.code;
+		}
+
+		const action_t* a = pNode.pAction;
+		Uint8 device;
+		if (pInput.type == COMBO_INPUT_KEY)
+		{
+			if (a->key == pInput.code) return true;
+			device = CONTROLLER_KEYBOARDMOUSE;
+		}
+		else if (pInput.type == COMBO_INPUT_BUTTON)
+		{
+			if (a->button == pInput.code) return true;
+			device = CONTROLLER_GAMEPAD;
+		}
+		else
+		{
+			return false;
+		}
+
+		for (Uint8 i = 0; i < a->iBindingCount; i++)
+		{
+			if (a->bindings[i].device != device) continue;
+			for (Uint8 j = 0; j < a->bindings[i].count; j++)
+			{
+				if (a->bindings[i].inputs[j] == pInput.code) return true;
+			}
+		}
+
+		return false;
+	}
+
+	//-----------------------------------------------------------------------------
+	// Purpose: Compile a combo into the trie. Returns its index or -1.
+	//-----------------------------------------------------------------------------
+	int RegisterCombo(const std::string& pComboName, const combostep_t* pSteps, Uint8 iCount, Uint32 iWindow)
+	{
+		if (iCount == 0 || rinput_context->vComboNames.size() >= COMBO_MAX)
+		{
+			printf("Failed to register combo '%s'.\n", pComboName.c_str());
+			return -1;
+		}
+
+		if (rinput_context->vComboNodes.empty())
+		{
+			combonode_t root = { 0, 0, NULL, 0, -1, -1, -1 };
+			rinput_context->vComboNodes.push_back(root);
+		}
+
+		int iCombo = (int)rinput_context->vComboNames.size();
+		int parent = 0;
+
+		for (Uint8 i = 0; i < iCount; i++)
+		{
+			combonode_t n;
+			n.type = pSteps[i].type;
+			n.code = pSteps[i].type == COMBO_STEP_DIRECTION ? pSteps[i].direction : 0;
+			n.pAction = pSteps[i].type == COMBO_STEP_ACTION ? &GetAction(pSteps[i].pszAction) : NULL;
+			n.iWindow = iWindow;
+			n.iChild = -1;
+			n.iSibling = -1;
+			n.iCombo = -1;
+
+			int found = -1;
+			for (int c = rinput_context->vComboNodes[parent].iChild; c != -1; c = rinput_context->vComboNodes[c].iSibling)
+			{
+				const combonode_t& o = rinput_context->vComboNodes[c];
+				if (o.type == n.type && o.code == n.code && o.pAction == n.pAction && o.iWindow == n.iWindow)
+				{
+					found = c;
+					break;
+				}
+			}
+
+			if (found == -1)
+			{
+				n.iSibling = rinput_context->vComboNodes[parent].iChild;
+				found = (int)rinput_context->vComboNodes.size();
+				rinput_context->vComboNodes.push_back(n);
+				rinput_context->vComboNodes[parent].iChild = found;
+			}
+
+			parent = found;
+		}
+
+		if (rinput_context->vComboNodes[parent].iCombo >= 0)
+		{
+			printf("Failed to register combo '%s' as it has the same steps as '%s'.\n", pComboName.c_str(), rinput_context->vComboNames[rinput_context->vComboNodes[parent].iCombo].c_str());
+			return -1;
+		}
+
+		rinput_context->vComboNodes[parent].iCombo = iCombo;
+		rinput_context->vComboNames.push_back(pComboName);
+		return iCombo;
+	}
+
+	//-----------------------------------------------------------------------------
+	// Purpose: Look up a combo's index by name.
+	//-----------------------------------------------------------------------------
+	int GetComboIndex(const std::string& pComboName)
+	{
+		for (size_t i = 0; i < rinput_context->vComboNames.size(); i++)
+		{
+			if (rinput_context->vComboNames[i] == pComboName) return (int)i;
+		}
+
+		return -1;
+	}
+
+	//-----------------------------------------------------------------------------
+	// Purpose: Keep one thread per node, the most recent one.
+	//-----------------------------------------------------------------------------
+	void _ComboAddThread(combothread_t* pThreads, int& iCount, int node, Uint32 last)
+	{
+		for (int i = 0; i < iCount; i++)
+		{
+			if (pThreads[i].node == node)
+			{
+				if (last > pThreads[i].last) pThreads[i].last = last;
+				return;
+			}
+		}
+
+		if (iCount < COMBO_MAX_THREADS)
+		{
+			pThreads[iCount].node = node;
+			pThreads[iCount].last = last;
+			iCount++;
+		}
+	}
+
+	//-----------------------------------------------------------------------------
+	// Purpose: Advance a thread that reached pNode at time 'last', adding a
+	// thread to pNext for every child the input matches, since combos that
+	// share a prefix can differ only in their windows. The thread stays put
+	// if the input didn't concern it, and dies if the input broke the combo
+	// or every next step has timed out.
+	//-----------------------------------------------------------------------------
+	void _ComboAdvance(comboplayer_t& pPlayer, int pNode, Uint32 last, const comboinput_t& pInput, combothread_t* pNext, int& iNext)
+	{
+		bool bAlive = false;
+		bool bSameKind = false;
+		bool bMatched = false;
+		for (int c = rinput_context->vComboNodes[pNode].iChild; c != -1; c = rinput_context->vComboNodes[c].iSibling)
+		{
+			const combonode_t& n = rinput_context->vComboNodes[c];
+			if (pNode != 0 && pInput.timestamp - last > n.iWindow) continue;
+			bAlive = true;
+
+			if (_ComboStepMatches(n, pInput))
+			{
+				if (n.iCombo >= 0) pPlayer.iTriggered |= (Uint64)1 << n.iCombo;
+				if (n.iChild != -1) _ComboAddThread(pNext, iNext, c, pInput.timestamp);
+				bMatched = true;
+				continue;
+			}
+
+			if ((n.type == COMBO_STEP_DIRECTION) == (pInput.type == COMBO_INPUT_DIRECTION)) bSameKind = true;
+		}
+
+		// A wrong direction breaks a motion and a wrong button breaks a
+		// button sequence; the other kind of input is allowed in between.
+		if (pNode != 0 && !bMatched && bAlive && !bSameKind) _ComboAddThread(pNext, iNext, pNode, last);
+	}
+
+	//-----------------------------------------------------------------------------
+	// Purpose: Record an input and step every live thread. Cost is the number
+	// of live threads plus the number of possible first steps.
+	//-----------------------------------------------------------------------------
+	void PushComboInput(const int iPlayer, Uint8 type, Sint32 code, Uint32 timestamp)
+	{
+		if (iPlayer < 0 || iPlayer >= COMBO_MAX_PLAYERS) return;
+
+		comboplayer_t& p = rinput_context->combo_players[iPlayer];
+		comboinput_t input;
+		input.type = type;
+		input.code = code;
+		input.timestamp = timestamp;
+		p.history[p.iHistoryCount % COMBO_HISTORY] = input;
+		p.iHistoryCount++;
+
+		if (rinput_context->vComboNodes.empty()) return;
+
+		combothread_t next[COMBO_MAX_THREADS];
+		int iNext = 0;
+
+		for (int i = 0; i < p.iThreadCount; i++)
+		{
+			_ComboAdvance(p, p.threads[i].node, p.threads[i].last, input, next, iNext);
+		}
+
+		// Every input may also be the start of a combo.
+		_ComboAdvance(p, 0, timestamp, input, next, iNext);
+
+		for (int i = 0; i < iNext; i++)
+		{
+			p.threads[i] = next[i];
+		}
+		p.iThreadCount = iNext;
+	}
+
+	//-----------------------------------------------------------------------------
+	// Purpose: Returns true once per completion of the combo.
+	//-----------------------------------------------------------------------------
+	bool OnCombo(const int iCombo, const int iPlayer)
+	{
+		if (iCombo < 0 || iCombo >= COMBO_MAX || iPlayer < 0 || iPlayer >= COMBO_MAX_PLAYERS) return false;
+
+		Uint64 bit = (Uint64)1 << iCombo;
+		bool b = (rinput_context->combo_players[iPlayer].iTriggered & bit) != 0;
+		rinput_context->combo_players[iPlayer].iTriggered &= ~bit;
+		return b;
+	}
+
+	//-----------------------------------------------------------------------------
+	// Purpose: Returns an input from the history, 0 being the latest.
+	//-----------------------------------------------------------------------------
+	bool GetComboHistory(const int iPlayer, const Uint32 iAge, comboinput_t& pInput)
+	{
+		if (iPlayer < 0 || iPlayer >= COMBO_MAX_PLAYERS) return false;
+
+		const comboplayer_t& p = rinput_context->combo_players[iPlayer];
+		if (iAge >= COMBO_HISTORY || iAge >= p.iHistoryCount) return false;
+
+		pInput = p.history[(p.iHistoryCount - 1 - iAge) % COMBO_HISTORY];
+		return true;
+	}
+
+	//-----------------------------------------------------------------------------
+	// Purpose: Mirror left and right, for a player facing the other way.
+	//-----------------------------------------------------------------------------
+	void SetComboFacing(const int iPlayer, bool bFlipped)
+	{
+		if (iPlayer < 0 || iPlayer >= COMBO_MAX_PLAYERS) return;
+		rinput_context->combo_players[iPlayer].bFlipped = bFlipped;
+	}
+
+	//-----------------------------------------------------------------------------
+	// Purpose: Keys player one uses for directions on keyboard.
+	//-----------------------------------------------------------------------------
+	void SetComboDirectionKeys(Sint32 iUp, Sint32 iDown, Sint32 iLeft, Sint32 iRight)
+	{
+		rinput_context->combo_keys[0] = iUp;
+		rinput_context->combo_keys[1] = iDown;
+		rinput_context->combo_keys[2] = iLeft;
+		rinput_context->combo_keys[3] = iRight;
+	}
+
+	//-----------------------------------------------------------------------------
+	// Purpose: Combine the direction sources and push a transition if the
+	// numpad direction changed.
+	//-----------------------------------------------------------------------------
+	void _ComboUpdateDirection(const int iPlayer, Uint32 timestamp)
+	{
+		comboplayer_t& p = rinput_context->combo_players[iPlayer];
+
+		Uint8 bits = p.dpad | p.keys;
+		if (p.stickY < -GAMEPAD_THUMB_DEADZONE) bits |= COMBO_DIR_UP;
+		if (p.stickY > GAMEPAD_THUMB_DEADZONE) bits |= COMBO_DIR_DOWN;
+		if (p.stickX < -GAMEPAD_THUMB_DEADZONE) bits |= COMBO_DIR_LEFT;
+		if (p.stickX > GAMEPAD_THUMB_DEADZONE) bits |= COMBO_DIR_RIGHT;
+
+		int dir = 5;
+		if ((bits & COMBO_DIR_UP) && !(bits & COMBO_DIR_DOWN)) dir += 3;
+		if ((bits & COMBO_DIR_DOWN) && !(bits & COMBO_DIR_UP)) dir -= 3;
+
+		int h = 0;
+		if ((bits & COMBO_DIR_RIGHT) && !(bits & COMBO_DIR_LEFT)) h = 1;
+		if ((bits & COMBO_DIR_LEFT) && !(bits & COMBO_DIR_RIGHT)) h = -1;
+		dir += p.bFlipped ? -h : h;
+
+		if (p.direction == 0) p.direction = 5;
+		if (dir != p.direction)
+		{
+			p.direction = (Uint8)dir;
+			PushComboInput(iPlayer, COMBO_INPUT_DIRECTION, dir, timestamp);
+		}
+	}
+
+	Uint8 _ComboDPadBit(const Uint8& pButton)
+	{
+		switch (pButton)
+		{
+		case GAMEPAD_BUTTON_DUP: return COMBO_DIR_UP;
+		case GAMEPAD_BUTTON_DDOWN: return COMBO_DIR_DOWN;
+		case GAMEPAD_BUTTON_DLEFT: return COMBO_DIR_LEFT;
+		case GAMEPAD_BUTTON_DRIGHT: return COMBO_DIR_RIGHT;
+		default: return 0;
+		}
+	}
+
+	//-----------------------------------------------------------------------------
+	// Purpose: Turn a device's inputs into combo inputs. Shared by the SDL
+	// events and injected records, so bots and remote players can combo.
+	//-----------------------------------------------------------------------------
+	void _ComboPadButton(const int iPlayer, const Uint8& pButton, bool bDown, Uint32 ts)
+	{
+		if (rinput_context->vComboNodes.empty() || iPlayer < 0 || iPlayer >= COMBO_MAX_PLAYERS) return;
+
+		Uint8 bit = _ComboDPadBit(pButton);
+		if (bit != 0)
+		{
+			if (bDown) rinput_context->combo_players[iPlayer].dpad |= bit;
+			else rinput_context->combo_players[iPlayer].dpad &= ~bit;
+			_ComboUpdateDirection(iPlayer, ts);
+		}
+		else if (bDown)
+		{
+			PushComboInput(iPlayer, COMBO_INPUT_BUTTON, pButton, ts);
+		}
+	}
+
+	void _ComboPadAxis(const int iPlayer, const Uint32& pAxis, const Sint16& iValue, Uint32 ts)
+	{
+		if (rinput_context->vComboNodes.empty() || iPlayer < 0 || iPlayer >= COMBO_MAX_PLAYERS) return;
+
+		if (pAxis == SDL_CONTROLLER_AXIS_LEFTX) rinput_context->combo_players[iPlayer].stickX = iValue;
+		else if (pAxis == SDL_CONTROLLER_AXIS_LEFTY) rinput_context->combo_players[iPlayer].stickY = iValue;
+		else return;
+
+		_ComboUpdateDirection(iPlayer, ts);
+	}
+
+	void _ComboKey(const Sint32& pKey, bool bDown, Uint32 ts)
+	{
+		if (rinput_context->vComboNodes.empty()) return;
+
+		Uint8 bit = 0;
+		if (pKey == rinput_context->combo_keys[0]) bit = COMBO_DIR_UP;
+		else if (pKey == rinput_context->combo_keys[1]) bit = COMBO_DIR_DOWN;
+		else if (pKey == rinput_context->combo_keys[2]) bit = COMBO_DIR_LEFT;
+		else if (pKey == rinput_context->combo_keys[3]) bit = COMBO_DIR_RIGHT;
+
+		if (bit != 0)
+		{
+			if (bDown) rinput_context->combo_players[0].keys |= bit;
+			else rinput_context->combo_players[0].keys &= ~bit;
+			_ComboUpdateDirection(0, ts);
+		}
+		else if (bDown)
+		{
+			PushComboInput(0, COMBO_INPUT_KEY, pKey, ts);
+		}
+	}
+
+	//-----------------------------------------------------------------------------
+	// Purpose: Turn SDL events into combo inputs. Called by TestEvents.
+	//-----------------------------------------------------------------------------
+	void ComboTestEvent(const SDL_Event& pEvent)
+	{
+		if (rinput_context->vComboNodes.empty()) return;
+
+		Uint32 ts = pEvent.common.timestamp;
+
+		switch (pEvent.type)
+		{
+		case SDL_CONTROLLERBUTTONDOWN:
+		case SDL_CONTROLLERBUTTONUP:
+			_ComboPadButton(pEvent.cbutton.which, pEvent.cbutton.button, pEvent.type == SDL_CONTROLLERBUTTONDOWN, ts);
+			break;
+
+		case SDL_CONTROLLERAXISMOTION:
+			_ComboPadAxis(pEvent.caxis.which, pEvent.caxis.axis, pEvent.caxis.value, ts);
+			break;
+
+		case SDL_KEYDOWN:
+		case SDL_KEYUP:
+			if (pEvent.key.repeat) break;
+			_ComboKey(pEvent.key.keysym.sym, pEvent.type == SDL_KEYDOWN, ts);
+			break;
+
+		default:
+			break;
+		}
+	}
+}
@@ -0,0 +1,349 @@
+/*
+MIT License
+
+Copyright (c) 2019 Reep Softworks
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+
+#ifndef RINPUT_CONTEXT_H
+#define RINPUT_CONTEXT_H
+#if defined( _WIN32 )
+#pragma once
+#endif
+
+// Internal: the state behind the API. Only the library's sources include this.
+
+#include <vector>
+#include <map>
+#include <string>
+#include <atomic>
+#include "rinput.h"
+
+#define COMBO_MAX_PLAYERS (RInput_GamePad::ENUM_GAMEPAD_MAX + 1)
+#define COMBO_MAX_THREADS 16
+
+// Bump a counter for the frame; cheap enough to leave everywhere.
+#define RINPUT_COUNT(field) (RInput::rinput_context->counters.field++)
+
+namespace RInput
+{
+	//-----------------------------------------------------------------------------
+	// Purpose: A look action. The config is folded into a couple of scales
+	// when it changes so the per-frame pass is a handful of multiplies.
+	//-----------------------------------------------------------------------------
+	typedef struct
+	{
+		std::string name;
+		Sint8 stick;
+		lookconfig_t config;
+
+		// Precomputed from config.
+		float fMouseScale;
+		float fMouseAccel;
+		float fInvert;
+
+		// Output for the frame, plus what didn't fit in whole units.
+		float x, y;
+		int iX, iY;
+		float fRemainderX, fRemainderY;
+
+	} look_t;
+
+	//-----------------------------------------------------------------------------
+	// Purpose: State machine for one interaction. Kept in a flat array;
+	// presses and releases step it as they arrive, Update does the rest.
+	//-----------------------------------------------------------------------------
+	typedef struct
+	{
+		action_t* pAction;
+		Uint32 iMs;
+		Uint32 iSeen;		// Last press time we've processed.
+		Uint32 iStart;		// When the current press began.
+		Uint32 iLastTap;	// Previous press, for double taps.
+		Uint8 type;
+		bool bHeld;
+		bool bFired;
+		bool bActive;
+		bool bTriggered;
+		bool bPending;		// Triggered since the last Update, by an edge.
+
+	} interaction_t;
+
+	//-----------------------------------------------------------------------------
+	// Purpose: Registered combos are compiled into a trie; each node is one
+	// step. Combos with the same leading steps (and windows) share nodes, so
+	// a new input only has to be tested against the children of the nodes
+	// players are currently sitting on.
+	//-----------------------------------------------------------------------------
+	typedef struct
+	{
+		Uint8 type;
+		Sint32 code;
+		action_t* pAction;
+		Uint32 iWindow;
+		int iChild;
+		int iSibling;
+		int iCombo;
+
+	} combonode_t;
+
+	typedef struct
+	{
+		int node;
+		Uint32 last;
+
+	} combothread_t;
+
+	typedef struct
+	{
+		comboinput_t history[COMBO_HISTORY];
+		Uint32 iHistoryCount;
+
+		combothread_t threads[COMBO_MAX_THREADS];
+		int iThreadCount;
+
+		Uint64 iTriggered;
+		bool bFlipped;
+
+		// Raw direction sources, combined into a numpad direction.
+		Uint8 direction;
+		Uint8 dpad;
+		Uint8 keys;
+		Sint16 stickX;
+		Sint16 stickY;
+
+	} comboplayer_t;
+
+	//-----------------------------------------------------------------------------
+	// Purpose: Haptic patterns. Every pattern's keyframes live in one array;
+	// a pattern is just a range of it.
+	//-----------------------------------------------------------------------------
+	typedef struct
+	{
+		std::string name;
+		Uint32 iFirst;
+		Uint16 iCount;
+		Uint32 iLength; // Time of the last key.
+		bool bLoop;
+
+	} haptic_t;
+
+#ifndef RINPUT_NO_RUMBLE
+	//-----------------------------------------------------------------------------
+	// Purpose: Effects playing on a pad. Slots with iEnd == 0 are free.
+	//-----------------------------------------------------------------------------
+	typedef struct
+	{
+		Uint16 left;
+		Uint16 right;
+		Uint8 priority;
+		Uint32 iEnd;
+		int id;
+
+	} rumbleeffect_t;
+
+	typedef struct
+	{
+		rumbleeffect_t effects[RUMBLE_MAX_EFFECTS];
+		Uint16 iSentLeft;
+		Uint16 iSentRight;
+		Uint32 iSentTime;
+
+	} rumblepad_t;
+
+	//-----------------------------------------------------------------------------
+	// Purpose: Patterns playing on the pads. Slots with id < 0 are free.
+	//-----------------------------------------------------------------------------
+	typedef struct
+	{
+		int id;
+		Sint16 haptic;
+		Uint8 port;
+		Uint8 priority;
+		Uint16 iKey; // Last key passed, so sampling doesn't search.
+		Uint32 iStart;
+
+	} hapticplay_t;
+#endif
+
+	//-----------------------------------------------------------------------------
+	// Purpose: A bounded multi-producer, single-consumer queue. A cell's
+	// sequence is its position while free and position + 1 once filled, so
+	// producers claim cells with a single CAS on tail and never wait on each
+	// other. The cells sit between tail and head to keep the producers' and
+	// the consumer's counters on different cache lines.
+	//-----------------------------------------------------------------------------
+	typedef struct
+	{
+		std::atomic<size_t> seq;
+		inputrecord_t record;
+		Sint32 port;
+
+	} queuecell_t;
+
+	struct inputqueue_t
+	{
+		std::atomic<size_t> tail;
+		std::atomic<Uint32> iQueued;
+		std::atomic<Uint32> iDropped;
+		queuecell_t cells[RINPUT_INPUT_QUEUE_SIZE];
+		size_t head;
+		Uint32 iHighWater;
+
+		// Records taken off the ring, in timestamp order, waiting for their
+		// time to come. Same size as the ring, so nothing allocates.
+		inputrecord_t staged[RINPUT_INPUT_QUEUE_SIZE];
+		Sint32 stagedPort[RINPUT_INPUT_QUEUE_SIZE];
+		Uint32 iStaged;
+
+		inputqueue_t();
+	};
+
+	//-----------------------------------------------------------------------------
+	// Purpose: One input stack. Everything the API reads or writes lives
+	// here, in one object, so several stacks can run side by side.
+	// Zeroed on creation; only the fields that start non-zero have
+	// initializers.
+	//-----------------------------------------------------------------------------
+	struct Context
+	{
+		SDL_Window* window;
+		SDL_Event event;	// Last event of a new type seen by TestEvents.
+
+		Controllers_t active_device;
+		Sint8 gamepad_count;
+		std::map<std::string, action_t> mActions;
+		std::vector<action_t*> vActionSlots; // <- By action_t::iSlot.
+
+		// Keyboard + mouse. SDL keycodes are either characters (< 128) or a
+		// scancode with SDLK_SCANCODE_MASK set, so nearly every key (and our
+		// fake mouse buttons) folds into a flat table. Anything else lands in
+		// mButton.
+		bool bKeyState[RINPUT_KEYSTATE_SIZE];
+		Uint32 iKeyPressTime[RINPUT_KEYSTATE_SIZE];
+		Uint32 iKeyReleaseTime[RINPUT_KEYSTATE_SIZE];
+		std::map<Sint32, bool> mButton;
+		bool bEnabled;
+		int mouseX, mouseY;
+		int iMotionX, iMotionY;
+		int iMouseDeltaX, iMouseDeltaY;
+		Uint32 iMouseButtons;
+		int iWheelAccum, iWheelDelta;
+		float fWheelAccum, fWheelDelta;
+		bool bWheelFrames; // <- Update() has run, so the wheel is per frame.
+
+		// GamePads.
+		RInput_GamePad::gamepad_t m_arrayControllers[RInput_GamePad::ENUM_GAMEPAD_MAX + 1];
+		bool bAxisButtons[RInput_GamePad::ENUM_GAMEPAD_MAX + 1][GAMEPAD_BUTTON_COUNT];
+		Uint32 iPressTime[RInput_GamePad::ENUM_GAMEPAD_MAX + 1][GAMEPAD_BUTTON_COUNT];
+		Uint32 iReleaseTime[RInput_GamePad::ENUM_GAMEPAD_MAX + 1][GAMEPAD_BUTTON_COUNT];
+		Sint16 iAxisRaw[RInput_GamePad::ENUM_GAMEPAD_MAX + 1][SDL_CONTROLLER_AXIS_MAX];
+
+		// Looks.
+		std::vector<look_t> vLooks;
+		Uint64 look_last_counter;
+
+		// Interactions.
+		std::vector<interaction_t> vInteractions;
+
+		// Combos.
+		std::vector<combonode_t> vComboNodes;
+		std::vector<std::string> vComboNames;
+		comboplayer_t combo_players[COMBO_MAX_PLAYERS];
+		Sint32 combo_keys[4] = { KEYBOARD_UP, KEYBOARD_DOWN, KEYBOARD_LEFT, KEYBOARD_RIGHT };
+
+		// Virtual cursor.
+		bool cursor_enabled;
+		Sint32 cursor_port;
+		Sint8 cursor_stick = GAMEPAD_AXIS_RSTICK;
+		float cursor_speed = 1000.0f;
+		float cursor_curve = 2.0f;
+		float cursor_x, cursor_y;
+		int cursor_last_x, cursor_last_y;
+		Uint64 cursor_last_counter;
+
+		// Snapshots. A buffer is free to write when no reader holds it and
+		// it isn't the latest.
+		inputsnapshot_t snapshots[RINPUT_SNAPSHOT_BUFFERS];
+		std::atomic<int> snapshot_refs[RINPUT_SNAPSHOT_BUFFERS];
+		std::atomic<int> snapshot_latest; // <- Buffer + 1, 0 before the first publish.
+		Uint32 snapshot_frame;
+		Uint32 snapshot_dropped;
+
+		// Counters for the frame in progress, the last finished one, and the
+		// budget watchdog.
+		inputcounters_t counters;
+		inputcounters_t counters_last;
+		Uint64 counters_poll_ticks;
+		Uint64 counters_update_start;
+		Uint32 counters_queue_dropped; // <- Totals seen at the last frame end.
+		Uint32 counters_snapshots_dropped;
+		Uint32 budget_micros;
+		BudgetCallback_t budget_callback;
+		void* budget_userdata;
+
+		// Bits per action in network frames, 0 for digital.
+		Uint8 frame_bits[RINPUT_MAX_ACTIONS];
+
+		// Input queued from other threads.
+		inputqueue_t input_queue;
+
+		// Haptic patterns.
+		std::vector<haptic_t> vHaptics;
+		std::vector<haptickey_t> vHapticKeys;
+
+#ifndef RINPUT_NO_RUMBLE
+		// Rumble.
+		rumblepad_t rumble_pads[RInput_GamePad::ENUM_GAMEPAD_MAX + 1];
+		int rumble_next_id;
+		hapticplay_t haptic_playing[HAPTIC_MAX_PLAYING];
+		int haptic_next_id;
+		bool haptic_playing_init;
+#endif
+	};
+
+	// The context the API works on for the calling thread.
+	extern thread_local Context* rinput_context;
+
+	void _CountEvent(const Uint32& iType);
+	void _FinishFrameCounters(); // <- End of Update.
+
+	// Combo inputs from a device, shared by the events and InjectInputs.
+	void _ComboPadButton(const int iPlayer, const Uint8& pButton, bool bDown, Uint32 ts);
+	void _ComboPadAxis(const int iPlayer, const Uint32& pAxis, const Sint16& iValue, Uint32 ts);
+	void _ComboKey(const Sint32& pKey, bool bDown, Uint32 ts);
+
+	// Action reads for the library's own use; they don't count as queries.
+	float _ActionValue(const action_t& pButton);
+	float _ActionValueOn(const action_t& pButton, const Uint8 device);
+	Sint16 _ActionValueFixed(const action_t& pButton);
+	Uint32 _ActionPressTime(const action_t& pAction);
+	Uint32 _ActionReleaseTime(const action_t& pAction);
+	void _DrainInputQueue(const Uint32 iUntil); // <- TestEvents, up to each event's time.
+	void _InteractionEdge(const Uint8 device, const Uint32 t); // <- After each button or axis change.
+}
+
+namespace RInput_KM
+{
+	int _KeyStateIndex(const Sint32& pKey);
+}
+
+#endif // RINPUT_CONTEXT_H
@@ -0,0 +1,358 @@
+/*
+MIT License
+
+Copyright (c) 2019 Reep Softworks
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#include <vector>
+#include <string>
+#include <algorithm>
+#include <string.h>
+#include "rinput.h"
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#endif
+
+namespace RInput_GamePad
+{
+	//-----------------------------------------------------------------------------
+	// Purpose: Where a mapping for a GUID sits inside the mapped database.
+	//-----------------------------------------------------------------------------
+	typedef struct
+	{
+		Uint8 guid[16];
+		Uint32 offset;
+		Uint32 length;
+
+	} mappingentry_t;
+
+	bool _EntryLess(const mappingentry_t& a, const mappingentry_t& b)
+	{
+		return memcmp(a.guid, b.guid, sizeof(a.guid)) < 0;
+	}
+
+	const char* mapping_data = NULL;
+	size_t mapping_size = 0;
+	bool mapping_indexed = false;
+	std::vector<mappingentry_t> vMappingIndex;
+
+#ifdef _WIN32
+	HANDLE mapping_file = INVALID_HANDLE_VALUE;
+	HANDLE mapping_view = NULL;
+#endif
+
+	//-----------------------------------------------------------------------------
+	// Purpose: Converts the 32 hex characters at the start of a line.
+	//-----------------------------------------------------------------------------
+	bool _ParseGUID(const char* pszHex, size_t iLen, Uint8* pGUID)
+	{
+		if (iLen < 32) return false;
+
+		for (int i = 0; i < 32; i++)
+		{
+			char c = pszHex[i];
+			Uint8 n;
+			if (c >= '0' && c <= '9') n = (Uint8)(c - '0');
+			else if (c >= 'a' && c <= 'f') n = (Uint8)(c - 'a' + 10);
+			else if (c >= 'A' && c <= 'F') n = (Uint8)(c - 'A' + 10);
+			else return false;
+
+			if (i & 1) pGUID[i / 2] |= n;
+			else pGUID[i / 2] = (Uint8)(n << 4);
+		}
+
+		return true;
+	}
+
+	//-----------------------------------------------------------------------------
+	// Purpose: Returns true if the line has no platform field, or it matches
+	// the platform we're running on (same rule SDL uses when loading the file).
+	//-----------------------------------------------------------------------------
+	bool _LineMatchesPlatform(const char* pszLine, size_t iLen)
+	{
+		static const char szField[] = "platform:";
+		static const size_t iFieldLen = sizeof(szField) - 1;
+
+		const char* pszPlatform = SDL_GetPlatform();
+		size_t iPlatformLen = strlen(pszPlatform);
+
+		for (size_t i = 0; i + iFieldLen <= iLen; i++)
+		{
+			if (memcmp(pszLine + i, szField, iFieldLen) != 0) continue;
+
+			const char* v = pszLine + i + iFieldLen;
+			size_t iRemain = iLen - i - iFieldLen;
+			return iRemain >= iPlatformLen && memcmp(v, pszPlatform, iPlatformLen) == 0 && (iRemain == iPlatformLen || v[iPlatformLen] == ',');
+		}
+
+		return true;
+	}
+
+	//-----------------------------------------------------------------------------
+	// Purpose: Walk the mapped file once and record every mapping for this
+	// platform. Done on the first unknown device, not at startup.
+	//-----------------------------------------------------------------------------
+	void _BuildMappingIndex()
+	{
+		mapping_indexed = true;
+		vMappingIndex.clear();
+
+		const char* p = mapping_data;
+		const char* end = mapping_data + mapping_size;
+
+		while (p < end)
+		{
+			const char* eol = (const char*)memchr(p, '\n', (size_t)(end - p));
+			if (eol == NULL) eol = end;
+
+			size_t iLen = (size_t)(eol - p);
+			if (iLen > 0 && p[iLen - 1] == '\r') iLen--;
+
+			mappingentry_t e;
+			if (iLen > 0 && p[0] != '#' && _ParseGUID(p, iLen, e.guid) && _LineMatchesPlatform(p, iLen))
+			{
+				e.offset = (Uint32)(p - mapping_data);
+				e.length = (Uint32)iLen;
+				vMappingIndex.push_back(e);
+			}
+
+			p = eol + 1;
+		}
+
+		// Later lines win in SDL, so keep the last entry of each GUID.
+		std::stable_sort(vMappingIndex.begin(), vMappingIndex.end(), _EntryLess);
+		std::vector<mappingentry_t>::iterator out = vMappingIndex.begin();
+		for (std::vector<mappingentry_t>::iterator it = vMappingIndex.begin(); it != vMappingIndex.end(); ++it)
+		{
+			if (it + 1 != vMappingIndex.end() && !_EntryLess(*it, *(it + 1))) continue;
+			*out++ = *it;
+		}
+		vMappingIndex.erase(out, vMappingIndex.end());
+	}
+
+	//-----------------------------------------------------------------------------
+	// Purpose: Binary search the index for a GUID.
+	//-----------------------------------------------------------------------------
+	const mappingentry_t* _FindMapping(const Uint8* pGUID)
+	{
+		mappingentry_t key;
+		memcpy(key.guid, pGUID, sizeof(key.guid));
+
+		std::vector<mappingentry_t>::const_iterator it = std::lower_bound(vMappingIndex.begin(), vMappingIndex.end(), key, _EntryLess);
+		if (it != vMappingIndex.end() && memcmp(it->guid, pGUID, sizeof(key.guid)) == 0)
+		{
+			return &(*it);
+		}
+
+		return NULL;
+	}
+
+#ifdef RINPUT_EMBEDDED_GAMECONTROLLERDB
+	//-----------------------------------------------------------------------------
+	// Purpose: Table generated at build time by tools/mkcontrollerdb, sorted by
+	// GUID then platform. Platform 0 entries apply everywhere.
+	//-----------------------------------------------------------------------------
+	typedef struct
+	{
+		Uint8 guid[16];
+		Uint8 platform;
+		const char* mapping;
+
+	} embeddedmapping_t;
+
+	#include "controllerdb_table.inc"
+
+	static const int embedded_count = sizeof(embedded_mappings) / sizeof(embedded_mappings[0]);
+	int embedded_platform = -1;
+
+	//-----------------------------------------------------------------------------
+	// Purpose: Binary search the built in table, preferring an entry for this
+	// platform over a platform-less one.
+	//-----------------------------------------------------------------------------
+	const char* _FindEmbeddedMapping(const Uint8* pGUID)
+	{
+		if (embedded_platform < 0)
+		{
+			embedded_platform = 0;
+			const char* pszPlatform = SDL_GetPlatform();
+			for (int i = 1; i < (int)(sizeof(embedded_platforms) / sizeof(embedded_platforms[0])); i++)
+			{
+				if (strcmp(pszPlatform, embedded_platforms[i]) == 0) embedded_platform = i;
+			}
+		}
+
+		int lo = 0;
+		int hi = embedded_count;
+		while (lo < hi)
+		{
+			int mid = (lo + hi) / 2;
+			if (memcmp(embedded_mappings[mid].guid, pGUID, 16) < 0) lo = mid + 1;
+			else hi = mid;
+		}
+
+		const char* pszFallback = NULL;
+		for (int i = lo; i < embedded_count && memcmp(embedded_mappings[i].guid, pGUID, 16) == 0; i++)
+		{
+			if (embedded_mappings[i].platform == embedded_platform && embedded_platform != 0) return embedded_mappings[i].mapping;
+			if (embedded_mappings[i].platform == 0) pszFallback = embedded_mappings[i].mapping;
+		}
+
+		return pszFallback;
+	}
+#endif
+
+	//-----------------------------------------------------------------------------
+	// Purpose: Map the database into memory. No parsing happens here.
+	//-----------------------------------------------------------------------------
+	bool OpenMappingDatabase(const char* pszPath)
+	{
+		CloseMappingDatabase();
+
+#ifdef _WIN32
+		mapping_file = CreateFileA(pszPath, GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
+		if (mapping_file == INVALID_HANDLE_VALUE) return false;
+
+		LARGE_INTEGER size;
+		if (!GetFileSizeEx(mapping_file, &size) || size.QuadPart == 0)
+		{
+			CloseMappingDatabase();
+			return false;
+		}
+
+		mapping_view = CreateFileMappingA(mapping_file, NULL, PAGE_READONLY, 0, 0, NULL);
+		if (mapping_view == NULL)
+		{
+			CloseMappingDatabase();
+			return false;
+		}
+
+		mapping_data = (const char*)MapViewOfFile(mapping_view, FILE_MAP_READ, 0, 0, 0);
+		mapping_size = (size_t)size.QuadPart;
+#else
+		int fd = open(pszPath, O_RDONLY);
+		if (fd < 0) return false;
+
+		struct stat st;
+		if (fstat(fd, &st) != 0 || st.st_size == 0)
+		{
+			close(fd);
+			return false;
+		}
+
+		void* p = mmap(NULL, (size_t)st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+		close(fd);
+
+		if (p != MAP_FAILED)
+		{
+			mapping_data = (const char*)p;
+			mapping_size = (size_t)st.st_size;
+		}
+#endif
+
+		if (mapping_data == NULL)
+		{
+			CloseMappingDatabase();
+			return false;
+		}
+
+		return true;
+	}
+
+	//-----------------------------------------------------------------------------
+	// Purpose: Unmap the database and drop the index.
+	//-----------------------------------------------------------------------------
+	void CloseMappingDatabase()
+	{
+#ifdef _WIN32
+		if (mapping_data != NULL) UnmapViewOfFile(mapping_data);
+		if (mapping_view != NULL) CloseHandle(mapping_view);
+		if (mapping_file != INVALID_HANDLE_VALUE) CloseHandle(mapping_file);
+		mapping_view = NULL;
+		mapping_file = INVALID_HANDLE_VALUE;
+#else
+		if (mapping_data != NULL) munmap((void*)mapping_data, mapping_size);
+#endif
+		mapping_data = NULL;
+		mapping_size = 0;
+		mapping_indexed = false;
+		vMappingIndex.clear();
+	}
+
+	//-----------------------------------------------------------------------------
+	// Purpose: Give SDL a mapping for a joystick it can't use as a controller
+	// yet. SDL sends SDL_CONTROLLERDEVICEADDED itself once the mapping is in.
+	//-----------------------------------------------------------------------------
+	bool AddMappingForDevice(const Sint32& pWhich)
+	{
+		if (SDL_IsGameController(pWhich)) return false;
+
+		SDL_JoystickGUID guid = SDL_JoystickGetDeviceGUID(pWhich);
+		std::string s;
+
+		// Newer SDL stores a name CRC in bytes 2-3; the database doesn't,
+		// so a second lookup is made with them cleared.
+		for (int iPass = 0; iPass < 2 && s.empty(); iPass++)
+		{
+			if (iPass == 1)
+			{
+				guid.data[2] = 0;
+				guid.data[3] = 0;
+			}
+
+#ifdef RINPUT_EMBEDDED_GAMECONTROLLERDB
+			const char* pszMapping = _FindEmbeddedMapping(guid.data);
+			if (pszMapping != NULL)
+			{
+				s = pszMapping;
+				break;
+			}
+#endif
+
+			if (mapping_data != NULL)
+			{
+				if (!mapping_indexed)
+				{
+					_BuildMappingIndex();
+				}
+
+				const mappingentry_t* e = _FindMapping(guid.data);
+				if (e != NULL) s.assign(mapping_data + e->offset, e->length);
+			}
+		}
+
+		if (s.empty()) return false;
+
+		if (SDL_GameControllerAddMapping(s.c_str()) == -1)
+		{
+			printf("Failed to add controller mapping! SDL Error: %s\n", SDL_GetError());
+			return false;
+		}
+
+		return true;
+	}
+}
@@ -0,0 +1,97 @@
+/*
+MIT License
+
+Copyright (c) 2019 Reep Softworks
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#include <vector>
+#include <string>
+#include <string.h>
+#include "rinput.h"
+#include "context.h"
+
+namespace RInput
+{
+	//-----------------------------------------------------------------------------
+	// Purpose: Count an event by the range SDL puts its type in.
+	//-----------------------------------------------------------------------------
+	void _CountEvent(const Uint32& iType)
+	{
+		int c;
+		if (iType >= SDL_KEYDOWN && iType < SDL_MOUSEMOTION) c = INPUT_EVENTS_KEYBOARD;
+		else if (iType >= SDL_MOUSEMOTION && iType < SDL_JOYAXISMOTION) c = INPUT_EVENTS_MOUSE;
+		else if (iType >= SDL_JOYAXISMOTION && iType < SDL_FINGERDOWN) c = INPUT_EVENTS_GAMEPAD;
+		else c = INPUT_EVENTS_OTHER;
+
+		rinput_context->counters.iEvents[c]++;
+	}
+
+	Uint32 _TicksToMicros(const Uint64 iTicks)
+	{
+		Uint64 freq = SDL_GetPerformanceFrequency();
+		if (freq == 0) return 0;
+		return (Uint32)(iTicks * 1000000 / freq);
+	}
+
+	//-----------------------------------------------------------------------------
+	// Purpose: Close the frame's counters, start the next frame from zero and
+	// run the watchdog. Called at the end of Update.
+	//-----------------------------------------------------------------------------
+	void _FinishFrameCounters()
+	{
+		Context* ctx = rinput_context;
+		inputcounters_t& c = ctx->counters;
+
+		Uint32 dropped = ctx->input_queue.iDropped.load(std::memory_order_relaxed);
+		c.iQueueDropped = dropped - ctx->counters_queue_dropped;
+		ctx->counters_queue_dropped = dropped;
+
+		c.iSnapshotsDropped = ctx->snapshot_dropped - ctx->counters_snapshots_dropped;
+		ctx->counters_snapshots_dropped = ctx->snapshot_dropped;
+
+		c.iPollMicros = _TicksToMicros(ctx->counters_poll_ticks);
+		c.iUpdateMicros = _TicksToMicros(SDL_GetPerformanceCounter() - ctx->counters_update_start);
+
+		ctx->counters_last = c;
+		Uint32 frame = c.iFrame;
+		memset(&c, 0, sizeof(c));
+		c.iFrame = frame + 1;
+		ctx->counters_poll_ticks = 0;
+
+		const inputcounters_t& last = ctx->counters_last;
+		if (ctx->budget_micros != 0 && ctx->budget_callback != NULL && last.iPollMicros + last.iUpdateMicros > ctx->budget_micros)
+		{
+			ctx->budget_callback(last, ctx->budget_userdata);
+		}
+	}
+
+	const inputcounters_t& GetInputCounters()
+	{
+		return rinput_context->counters_last;
+	}
+
+	void SetInputBudget(const Uint32 iMicros, BudgetCallback_t pCallback, void* pUserData)
+	{
+		rinput_context->budget_micros = iMicros;
+		rinput_context->budget_callback = pCallback;
+		rinput_context->budget_userdata = pUserData;
+	}
+}
@@ -0,0 +1,129 @@
+/*
+MIT License
+
+Copyright (c) 2019 Reep Softworks
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+
+#include <math.h>
+#include "rinput.h"
+#include "context.h"
+
+namespace RInput
+{
+	//-----------------------------------------------------------------------------
+	// Purpose: Drive the mouse cursor with a stick. Moves in Update().
+	//-----------------------------------------------------------------------------
+	void EnableGamePadCursor(const Sint32& pWhich, const Sint8& pAxis)
+	{
+		if (!rinput_context->cursor_enabled)
+		{
+			rinput_context->cursor_last_x = RInput_KM::GetMouseX();
+			rinput_context->cursor_last_y = RInput_KM::GetMouseY();
+			rinput_context->cursor_x = (float)rinput_context->cursor_last_x;
+			rinput_context->cursor_y = (float)rinput_context->cursor_last_y;
+			rinput_context->cursor_last_counter = 0;
+		}
+
+		rinput_context->cursor_enabled = true;
+		rinput_context->cursor_port = pWhich;
+		rinput_context->cursor_stick = pAxis;
+	}
+
+	void DisableGamePadCursor()
+	{
+		rinput_context->cursor_enabled = false;
+	}
+
+	bool GetGamePadCursorEnabled()
+	{
+		return rinput_context->cursor_enabled;
+	}
+
+	//-----------------------------------------------------------------------------
+	// Purpose: fSpeed is pixels per second at full tilt, fCurve the stick
+	// response exponent.
+	//-----------------------------------------------------------------------------
+	void SetGamePadCursorSpeed(const float fSpeed, const float fCurve)
+	{
+		rinput_context->cursor_speed = fSpeed;
+		rinput_context->cursor_curve = fCurve;
+	}
+
+	//-----------------------------------------------------------------------------
+	// Purpose: Move the cursor by the stick over the real time since the last
+	// frame. Warps at most once, and only when the pixel position changes.
+	//-----------------------------------------------------------------------------
+	void UpdateGamePadCursor()
+	{
+		if (!rinput_context->cursor_enabled) return;
+
+		Uint64 now = SDL_GetPerformanceCounter();
+		float dt = 0.0f;
+		if (rinput_context->cursor_last_counter != 0)
+		{
+			dt = (float)((double)(now - rinput_context->cursor_last_counter) / (double)SDL_GetPerformanceFrequency());
+			if (dt > 0.25f) dt = 0.25f; // Don't jump after a hitch.
+		}
+		rinput_context->cursor_last_counter = now;
+
+		// The real mouse moved it since; carry on from there.
+		if (RInput_KM::GetMouseX() != rinput_context->cursor_last_x || RInput_KM::GetMouseY() != rinput_context->cursor_last_y)
+		{
+			rinput_context->cursor_last_x = RInput_KM::GetMouseX();
+			rinput_context->cursor_last_y = RInput_KM::GetMouseY();
+			rinput_context->cursor_x = (float)rinput_context->cursor_last_x;
+			rinput_context->cursor_y = (float)rinput_context->cursor_last_y;
+		}
+
+		float sx, sy;
+		RInput_GamePad::GetStickCurved(rinput_context->cursor_port, rinput_context->cursor_stick, rinput_context->cursor_curve, sx, sy);
+		if (sx == 0.0f && sy == 0.0f) return;
+
+		rinput_context->cursor_x += sx * rinput_context->cursor_speed * dt;
+		rinput_context->cursor_y += sy * rinput_context->cursor_speed * dt;
+
+		int w = 0, h = 0;
+		SDL_GetWindowSize(rinput_context->window, &w, &h);
+		if (rinput_context->cursor_x < 0.0f) rinput_context->cursor_x = 0.0f;
+		if (rinput_context->cursor_y < 0.0f) rinput_context->cursor_y = 0.0f;
+		if (w > 0 && rinput_context->cursor_x > (float)(w - 1)) rinput_context->cursor_x = (float)(w - 1);
+		if (h > 0 && rinput_context->cursor_y > (float)(h - 1)) rinput_context->cursor_y = (float)(h - 1);
+
+		int x = (int)floorf(rinput_context->cursor_x);
+		int y = (int)floorf(rinput_context->cursor_y);
+		if (x != rinput_context->cursor_last_x || y != rinput_context->cursor_last_y)
+		{
+			RInput_KM::SetMousePosition(x, y, false);
+			rinput_context->cursor_last_x = x;
+			rinput_context->cursor_last_y = y;
+		}
+	}
+
+	//-----------------------------------------------------------------------------
+	// Purpose: Kept for older code. Turns on the virtual cursor, which is
+	// moved by Update() from then on, so calling this every frame is fine.
+	//-----------------------------------------------------------------------------
+	void UpdateGamePadStickAsMouse(const Sint32& pWhich, const Sint8& pAxis)
+	{
+		EnableGamePadCursor(pWhich, pAxis);
+	}
+}
@@ -0,0 +1,298 @@
+/*
+MIT License
+
+Copyright (c) 2019 Reep Softworks
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#include <vector>
+#include <string>
+#include <math.h>
+#include "rinput.h"
+#include "context.h"
+
+#define FRAME_MAX_BITS 16
+
+namespace RInput
+{
+	//-----------------------------------------------------------------------------
+	// Purpose: Bit-level reader and writer, least significant bit first.
+	//-----------------------------------------------------------------------------
+	typedef struct
+	{
+		Uint8* p;
+		int iSize;
+		int iBit;
+		bool bOverflow;
+
+	} bitwriter_t;
+
+	typedef struct
+	{
+		const Uint8* p;
+		int iSize;
+		int iBit;
+		bool bOverflow;
+
+	} bitreader_t;
+
+	void _WriteBits(bitwriter_t& w, Uint32 v, const int iBits)
+	{
+		for (int i = 0; i < iBits; i++)
+		{
+			int byte = w.iBit >> 3;
+			if (byte >= w.iSize)
+			{
+				w.bOverflow = true;
+				return;
+			}
+
+			if ((w.iBit & 7) == 0) w.p[byte] = 0;
+			if (v & (1u << i)) w.p[byte] |= (Uint8)(1 << (w.iBit & 7));
+			w.iBit++;
+		}
+	}
+
+	Uint32 _ReadBits(bitreader_t& r, const int iBits)
+	{
+		Uint32 v = 0;
+		for (int i = 0; i < iBits; i++)
+		{
+			int byte = r.iBit >> 3;
+			if (byte >= r.iSize)
+			{
+				r.bOverflow = true;
+				return 0;
+			}
+
+			if (r.p[byte] & (1 << (r.iBit & 7))) v |= (1u << i);
+			r.iBit++;
+		}
+
+		return v;
+	}
+
+	//-----------------------------------------------------------------------------
+	// Purpose: Exp-Golomb; small numbers (frame steps, action counts) take a
+	// few bits.
+	//-----------------------------------------------------------------------------
+	void _WriteCount(bitwriter_t& w, const Uint32 v)
+	{
+		Uint64 x = (Uint64)v + 1;
+		int n = 0;
+		while ((x >> (n + 1)) != 0) n++;
+
+		_WriteBits(w, 0, n);
+		for (int i = n; i >= 0; i--)
+		{
+			_WriteBits(w, (Uint32)((x >> i) & 1), 1);
+		}
+	}
+
+	Uint32 _ReadCount(bitreader_t& r)
+	{
+		int n = 0;
+		while (_ReadBits(r, 1) == 0)
+		{
+			if (r.bOverflow || ++n > 32) return 0;
+		}
+
+		Uint64 x = 1;
+		for (int i = 0; i < n; i++)
+		{
+			x = (x << 1) | _ReadBits(r, 1);
+		}
+
+		return (Uint32)(x - 1);
+	}
+
+	//-----------------------------------------------------------------------------
+	// Purpose: An action's value on the wire: on/off, or a step between -max
+	// and max stored with max added.
+	//-----------------------------------------------------------------------------
+	int _FrameBits(const int iSlot)
+	{
+		Uint8 b = rinput_context->frame_bits[iSlot];
+		return b == 0 ? 1 : b;
+	}
+
+	Uint32 _Quantize(const float v, const int iBits)
+	{
+		if (iBits == 1) return v > 0.0f ? 1 : 0;
+
+		int max = (1 << (iBits - 1)) - 1;
+		float c = v < -1.0f ? -1.0f : (v > 1.0f ? 1.0f : v);
+		return (Uint32)((int)lroundf(c * (float)max) + max);
+	}
+
+	float _Dequantize(const Uint32 q, const int iBits)
+	{
+		if (iBits == 1) return (float)q;
+
+		int max = (1 << (iBits - 1)) - 1;
+		return (float)((int)q - max) / (float)max;
+	}
+
+	float _FrameAction(const inputframe_t* pFrame, const int i)
+	{
+		return (pFrame != NULL && i < pFrame->iActionCount) ? pFrame->fActions[i] : 0.0f;
+	}
+
+	void SetActionFrameBits(const int iSlot, const Uint8 iBits)
+	{
+		if (iSlot < 0 || iSlot >= RINPUT_MAX_ACTIONS) return;
+		rinput_context->frame_bits[iSlot] = (iBits > FRAME_MAX_BITS) ? FRAME_MAX_BITS : iBits;
+	}
+
+	//-----------------------------------------------------------------------------
+	// Purpose: The current value of every action, by slot.
+	//-----------------------------------------------------------------------------
+	void CaptureFrame(inputframe_t& pFrame, const Uint32 iFrame)
+	{
+		size_t count = rinput_context->vActionSlots.size();
+		if (count > RINPUT_MAX_ACTIONS) count = RINPUT_MAX_ACTIONS;
+
+		pFrame.iFrame = iFrame;
+		pFrame.iActionCount = (Uint16)count;
+		for (size_t i = 0; i < count; i++)
+		{
+			pFrame.fActions[i] = _ActionValue(*rinput_context->vActionSlots[i]);
+		}
+	}
+
+	//-----------------------------------------------------------------------------
+	// Purpose: Pack a frame. With a baseline only the frame step, a check
+	// byte and the actions whose wire value changed are sent, so an idle
+	// frame is two bytes.
+	//-----------------------------------------------------------------------------
+	int EncodeFrame(const inputframe_t& pFrame, const inputframe_t* pBaseline, Uint8* pBuffer, const int iSize)
+	{
+		if (pBuffer == NULL || iSize <= 0) return -1;
+
+		bitwriter_t w = { pBuffer, iSize, 0, false };
+		int count = pFrame.iActionCount > RINPUT_MAX_ACTIONS ? RINPUT_MAX_ACTIONS : pFrame.iActionCount;
+
+		// Frames can only build on older ones.
+		if (pBaseline != NULL && pFrame.iFrame <= pBaseline->iFrame) pBaseline = NULL;
+
+		_WriteBits(w, pBaseline != NULL, 1);
+		if (pBaseline != NULL)
+		{
+			_WriteCount(w, pFrame.iFrame - pBaseline->iFrame - 1);
+			_WriteBits(w, pBaseline->iFrame & 0xFF, 8);
+
+			bool bSameCount = count == pBaseline->iActionCount;
+			_WriteBits(w, bSameCount, 1);
+			if (!bSameCount) _WriteCount(w, (Uint32)count);
+
+			Uint32 q[RINPUT_MAX_ACTIONS];
+			bool bChanged = false;
+			for (int i = 0; i < count; i++)
+			{
+				int bits = _FrameBits(i);
+				q[i] = _Quantize(pFrame.fActions[i], bits);
+				if (q[i] != _Quantize(_FrameAction(pBaseline, i), bits)) bChanged = true;
+			}
+
+			_WriteBits(w, bChanged, 1);
+			if (bChanged)
+			{
+				for (int i = 0; i < count; i++)
+				{
+					int bits = _FrameBits(i);
+					bool bDiff = q[i] != _Quantize(_FrameAction(pBaseline, i), bits);
+					_WriteBits(w, bDiff, 1);
+					if (bDiff) _WriteBits(w, q[i], bits);
+				}
+			}
+		}
+		else
+		{
+			_WriteBits(w, pFrame.iFrame, 32);
+			_WriteCount(w, (Uint32)count);
+			for (int i = 0; i < count; i++)
+			{
+				int bits = _FrameBits(i);
+				_WriteBits(w, _Quantize(pFrame.fActions[i], bits), bits);
+			}
+		}
+
+		if (w.bOverflow) return -1;
+		return (w.iBit + 7) >> 3;
+	}
+
+	//-----------------------------------------------------------------------------
+	// Purpose: Unpack a frame. pBaseline has to be the frame it was encoded
+	// against; returns false if it isn't, or the data is cut short.
+	//-----------------------------------------------------------------------------
+	bool DecodeFrame(const Uint8* pBuffer, const int iSize, const inputframe_t* pBaseline, inputframe_t& pFrame)
+	{
+		if (pBuffer == NULL || iSize <= 0) return false;
+
+		bitreader_t r = { pBuffer, iSize, 0, false };
+		inputframe_t f;
+
+		if (_ReadBits(r, 1))
+		{
+			if (pBaseline == NULL) return false;
+
+			Uint32 step = _ReadCount(r);
+			if ((_ReadBits(r, 8) != (pBaseline->iFrame & 0xFF)) || r.bOverflow) return false;
+			f.iFrame = pBaseline->iFrame + step + 1;
+
+			Uint32 count = pBaseline->iActionCount;
+			if (!_ReadBits(r, 1)) count = _ReadCount(r);
+			if (count > RINPUT_MAX_ACTIONS) return false;
+			f.iActionCount = (Uint16)count;
+
+			bool bChanged = _ReadBits(r, 1) != 0;
+			for (Uint32 i = 0; i < count; i++)
+			{
+				int bits = _FrameBits((int)i);
+				if (bChanged && _ReadBits(r, 1))
+				{
+					f.fActions[i] = _Dequantize(_ReadBits(r, bits), bits);
+				}
+				else
+				{
+					f.fActions[i] = _Dequantize(_Quantize(_FrameAction(pBaseline, (int)i), bits), bits);
+				}
+			}
+		}
+		else
+		{
+			f.iFrame = _ReadBits(r, 32);
+			Uint32 count = _ReadCount(r);
+			if (count > RINPUT_MAX_ACTIONS) return false;
+			f.iActionCount = (Uint16)count;
+
+			for (Uint32 i = 0; i < count; i++)
+			{
+				int bits = _FrameBits((int)i);
+				f.fActions[i] = _Dequantize(_ReadBits(r, bits), bits);
+			}
+		}
+
+		if (r.bOverflow) return false;
+
+		pFrame = f;
+		return true;
+	}
+}
@@ -24,7 +24,10 @@ SOFTWARE.
 
 #include <map>
 #include <string>
+#include <string.h>
+#include <math.h>
 #include "rinput.h"
+#include "context.h"
 
 // TEMP: Fix for older SDL2
 #ifndef SDL_MAX_SINT16
@@ -33,7 +36,19 @@ SOFTWARE.
 
 namespace RInput_GamePad
 {
-	gamepad_t m_arrayControllers[GamePadIndex::ENUM_GAMEPAD_MAX];
+	using RInput::rinput_context;
+
+	//-----------------------------------------------------------------------------
+	// Purpose: Stamp a button transition for input buffering.
+	//-----------------------------------------------------------------------------
+	void _StampButton(const Sint32& pWhich, const Uint8& pButton, bool bDown, const Uint32 iTimestamp)
+	{
+		Uint32 t = iTimestamp != 0 ? iTimestamp : SDL_GetTicks();
+		if (t == 0) t = 1;
+
+		if (bDown) rinput_context->iPressTime[pWhich][pButton] = t;
+		else rinput_context->iReleaseTime[pWhich][pButton] = t;
+	}
 
 	//-----------------------------------------------------------------------------
 	// Purpose: Assign each device to a port.
@@ -42,16 +57,23 @@ namespace RInput_GamePad
 	{
 		if (pWhich <= ENUM_GAMEPAD_MAX)
 		{
-			if (m_arrayControllers[pWhich].controller == nullptr)
+			if (rinput_context->m_arrayControllers[pWhich].controller == nullptr)
 			{
-				m_arrayControllers[pWhich].controller = SDL_GameControllerOpen(pWhich);
-				m_arrayControllers[pWhich].pszDeviceName = SDL_GameControllerName(m_arrayControllers[pWhich].controller);
+				rinput_context->m_arrayControllers[pWhich].controller = SDL_GameControllerOpen(pWhich);
+				rinput_context->m_arrayControllers[pWhich].pszDeviceName = SDL_GameControllerName(rinput_context->m_arrayControllers[pWhich].controller);
 
 
-				m_arrayControllers[pWhich].bEnabled = true;
+				rinput_context->m_arrayControllers[pWhich].bEnabled = true;
+				rinput_context->m_arrayControllers[pWhich].bVirtual = false; // <- A real pad takes over.
 				Flush(pWhich);
 
-				printf("Connected GamePad '%s' into port %d\n", m_arrayControllers[pWhich].pszDeviceName, pWhich);
+				// Axis reads come from the events; seed them with where the pad is now.
+				for (Uint32 a = 0; a < SDL_CONTROLLER_AXIS_MAX; a++)
+				{
+					rinput_context->iAxisRaw[pWhich][a] = SDL_GameControllerGetAxis(rinput_context->m_arrayControllers[pWhich].controller, (SDL_GameControllerAxis)a);
+				}
+
+				printf("Connected GamePad '%s' into port %d\n", rinput_context->m_arrayControllers[pWhich].pszDeviceName, pWhich);
 			}
 			else
 			{
@@ -71,14 +93,14 @@ namespace RInput_GamePad
 	//-----------------------------------------------------------------------------
 	void Disconnect(const Sint32& pWhich)
 	{
-		if (m_arrayControllers[pWhich].controller != nullptr)
+		if (rinput_context->m_arrayControllers[pWhich].controller != nullptr)
 		{
 			printf("Disconnecting GamePad %d.\n", pWhich);
 			Flush(pWhich);
 
-			SDL_GameControllerClose(m_arrayControllers[pWhich].controller);
-			m_arrayControllers[pWhich].pszDeviceName = "";
-			m_arrayControllers[pWhich].bEnabled = false;
+			SDL_GameControllerClose(rinput_context->m_arrayControllers[pWhich].controller);
+			rinput_context->m_arrayControllers[pWhich].pszDeviceName = "";
+			rinput_context->m_arrayControllers[pWhich].bEnabled = false;
 		}
 	}
 
@@ -87,89 +109,240 @@ namespace RInput_GamePad
 	//-----------------------------------------------------------------------------
 	gamepad_t GetDeviceFromPort(const GamePadIndex& pPort)
 	{
-		if (m_arrayControllers[(Sint32)pPort].controller != NULL)
+		if (rinput_context->m_arrayControllers[(Sint32)pPort].controller != NULL)
 		{
-			return m_arrayControllers[(Sint32)pPort];
+			return rinput_context->m_arrayControllers[(Sint32)pPort];
 		}
 
-		return m_arrayControllers[0];
+		return rinput_context->m_arrayControllers[0];
+	}
+
+	//-----------------------------------------------------------------------------
+	// Purpose: Does the port take input: an open pad, or a virtual one?
+	//-----------------------------------------------------------------------------
+	bool IsPortLive(const Sint32& pWhich)
+	{
+		if (pWhich < 0 || pWhich > ENUM_GAMEPAD_MAX) return false;
+
+		const gamepad_t& pad = rinput_context->m_arrayControllers[pWhich];
+		return (pad.controller != nullptr && pad.bEnabled) || pad.bVirtual;
 	}
 
 	//-----------------------------------------------------------------------------
 	// Purpose: Record the state of the button.
 	//-----------------------------------------------------------------------------
-	void SimulateButton(const Sint32& pWhich, const Uint8& pButton, bool bDown)
+	void SimulateButton(const Sint32& pWhich, const Uint8& pButton, bool bDown, const Uint32 iTimestamp)
 	{
-		if (m_arrayControllers[pWhich].controller != nullptr && m_arrayControllers[pWhich].bEnabled == true)
+		if (pWhich < 0 || pWhich > ENUM_GAMEPAD_MAX || pButton >= SDL_CONTROLLER_BUTTON_MAX) return;
+
+		if (IsPortLive(pWhich))
 		{
-			m_arrayControllers[pWhich].mControllerButtons[pButton] = bDown;
+			if (rinput_context->m_arrayControllers[pWhich].bButtons[pButton] != bDown)
+			{
+				_StampButton(pWhich, pButton, bDown, iTimestamp);
+			}
+
+			rinput_context->m_arrayControllers[pWhich].bButtons[pButton] = bDown;
 		}
 	}
 
 	//-----------------------------------------------------------------------------
-	// Purpose: Return if the button is currently down.
+	// Purpose: Track the trigger and stick 'fake' buttons crossing their
+	// thresholds so they get press/release times like real buttons.
 	//-----------------------------------------------------------------------------
-	float ButtonDown(const Uint8& pButton, const GamePadIndex& iIndex)
+	void _UpdateAxisButton(const Sint32& pWhich, const Uint8& pButton, bool bDown, const Uint32 iTimestamp)
 	{
-		float val = 0.0f;
-		if (m_arrayControllers[(Sint32)iIndex].bEnabled == false) return val;
+		if (rinput_context->bAxisButtons[pWhich][pButton] != bDown)
+		{
+			rinput_context->bAxisButtons[pWhich][pButton] = bDown;
+			_StampButton(pWhich, pButton, bDown, iTimestamp);
+		}
+	}
 
-		if (pButton >= SDL_CONTROLLER_BUTTON_MAX)
+	void UpdateAxisMotions(const Sint32& pWhich, const Uint32& pAxis, const Sint16& pValue, const Uint32 iTimestamp)
+	{
+		if (pWhich < 0 || pWhich > ENUM_GAMEPAD_MAX) return;
+		if (pAxis < SDL_CONTROLLER_AXIS_MAX) rinput_context->iAxisRaw[pWhich][pAxis] = pValue;
+
+		switch (pAxis)
 		{
-			switch (pButton)
-			{
-			case GAMEPAD_BUTTON_LTRIGGER:
-				val = GetAxisFloat((Sint32)iIndex, SDL_CONTROLLER_AXIS_TRIGGERLEFT);
-				break;
+		case SDL_CONTROLLER_AXIS_TRIGGERLEFT:
+			_UpdateAxisButton(pWhich, GAMEPAD_BUTTON_LTRIGGER, pValue >= GAMEPAD_TRIGGER_THRESHOLD, iTimestamp);
+			break;
+
+		case SDL_CONTROLLER_AXIS_TRIGGERRIGHT:
+			_UpdateAxisButton(pWhich, GAMEPAD_BUTTON_RTRIGGER, pValue >= GAMEPAD_TRIGGER_THRESHOLD, iTimestamp);
+			break;
+
+		case SDL_CONTROLLER_AXIS_LEFTX:
+			_UpdateAxisButton(pWhich, GAMEPAD_BUTTON_LSTICK_LEFT, pValue <= -GAMEPAD_THUMB_DEADZONE, iTimestamp);
+			_UpdateAxisButton(pWhich, GAMEPAD_BUTTON_LSTICK_RIGHT, pValue >= GAMEPAD_THUMB_DEADZONE, iTimestamp);
+			break;
+
+		case SDL_CONTROLLER_AXIS_LEFTY:
+			_UpdateAxisButton(pWhich, GAMEPAD_BUTTON_LSTICK_UP, pValue <= -GAMEPAD_THUMB_DEADZONE, iTimestamp);
+			_UpdateAxisButton(pWhich, GAMEPAD_BUTTON_LSTICK_DOWN, pValue >= GAMEPAD_THUMB_DEADZONE, iTimestamp);
+			break;
+
+		case SDL_CONTROLLER_AXIS_RIGHTX:
+			_UpdateAxisButton(pWhich, GAMEPAD_BUTTON_RSTICK_LEFT, pValue <= -GAMEPAD_THUMB_DEADZONE, iTimestamp);
+			_UpdateAxisButton(pWhich, GAMEPAD_BUTTON_RSTICK_RIGHT, pValue >= GAMEPAD_THUMB_DEADZONE, iTimestamp);
+			break;
+
+		case SDL_CONTROLLER_AXIS_RIGHTY:
+			_UpdateAxisButton(pWhich, GAMEPAD_BUTTON_RSTICK_UP, pValue <= -GAMEPAD_THUMB_DEADZONE, iTimestamp);
+			_UpdateAxisButton(pWhich, GAMEPAD_BUTTON_RSTICK_DOWN, pValue >= GAMEPAD_THUMB_DEADZONE, iTimestamp);
+			break;
+
+		default:
+			break;
+		}
+	}
+
+	//-----------------------------------------------------------------------------
+	// Purpose: When the button last went down/up.
+	//-----------------------------------------------------------------------------
+	Uint32 ButtonPressTime(const Uint8& pButton, const GamePadIndex& iIndex)
+	{
+		if (pButton >= GAMEPAD_BUTTON_COUNT || iIndex < 0 || iIndex > ENUM_GAMEPAD_MAX) return 0;
+		return rinput_context->iPressTime[(Sint32)iIndex][pButton];
+	}
 
-			case GAMEPAD_BUTTON_RTRIGGER:
-				val = GetAxisFloat((Sint32)iIndex, SDL_CONTROLLER_AXIS_TRIGGERRIGHT);
-				break;
+	Uint32 ButtonReleaseTime(const Uint8& pButton, const GamePadIndex& iIndex)
+	{
+		if (pButton >= GAMEPAD_BUTTON_COUNT || iIndex < 0 || iIndex > ENUM_GAMEPAD_MAX) return 0;
+		return rinput_context->iReleaseTime[(Sint32)iIndex][pButton];
+	}
 
-			case GAMEPAD_BUTTON_LSTICK_UP:
-				val = -GetAxisFloat((Sint32)iIndex, SDL_CONTROLLER_AXIS_LEFTY);
-				break;
+	//-----------------------------------------------------------------------------
+	// Purpose: The axis behind a trigger or stick 'fake' button, -1 for real
+	// buttons.
+	//-----------------------------------------------------------------------------
+	int GetAxisButtonAxis(const Uint8& pButton)
+	{
+		switch (pButton)
+		{
+		case GAMEPAD_BUTTON_LTRIGGER: return SDL_CONTROLLER_AXIS_TRIGGERLEFT;
+		case GAMEPAD_BUTTON_RTRIGGER: return SDL_CONTROLLER_AXIS_TRIGGERRIGHT;
+		case GAMEPAD_BUTTON_LSTICK_UP:
+		case GAMEPAD_BUTTON_LSTICK_DOWN: return SDL_CONTROLLER_AXIS_LEFTY;
+		case GAMEPAD_BUTTON_LSTICK_LEFT:
+		case GAMEPAD_BUTTON_LSTICK_RIGHT: return SDL_CONTROLLER_AXIS_LEFTX;
+		case GAMEPAD_BUTTON_RSTICK_UP:
+		case GAMEPAD_BUTTON_RSTICK_DOWN: return SDL_CONTROLLER_AXIS_RIGHTY;
+		case GAMEPAD_BUTTON_RSTICK_LEFT:
+		case GAMEPAD_BUTTON_RSTICK_RIGHT: return SDL_CONTROLLER_AXIS_RIGHTX;
+		default: return -1;
+		}
+	}
 
-			case GAMEPAD_BUTTON_LSTICK_DOWN:
-				val = GetAxisFloat((Sint32)iIndex, SDL_CONTROLLER_AXIS_LEFTY, true);
-				break;
+	//-----------------------------------------------------------------------------
+	// Purpose: A fake button's value given its axis' raw reading. Up/left read
+	// the negative side of the axis, down/right the positive one.
+	//-----------------------------------------------------------------------------
+	float AxisButtonValue(const Uint8& pButton, const Sint16& iRaw)
+	{
+		int iAxis = GetAxisButtonAxis(pButton);
+		if (iAxis < 0) return 0.0f;
 
-			case GAMEPAD_BUTTON_LSTICK_LEFT:
-				val = -GetAxisFloat((Sint32)iIndex, SDL_CONTROLLER_AXIS_LEFTX);
-				break;
+		switch (pButton)
+		{
+		case GAMEPAD_BUTTON_LSTICK_UP:
+		case GAMEPAD_BUTTON_LSTICK_LEFT:
+		case GAMEPAD_BUTTON_RSTICK_UP:
+		case GAMEPAD_BUTTON_RSTICK_LEFT:
+			return -AxisToFloat(ShapeAxis(iRaw, (Uint32)iAxis, false));
+
+		case GAMEPAD_BUTTON_LSTICK_DOWN:
+		case GAMEPAD_BUTTON_LSTICK_RIGHT:
+		case GAMEPAD_BUTTON_RSTICK_DOWN:
+		case GAMEPAD_BUTTON_RSTICK_RIGHT:
+			return AxisToFloat(ShapeAxis(iRaw, (Uint32)iAxis, true));
+
+		default:
+			return AxisToFloat(ShapeAxis(iRaw, (Uint32)iAxis, false));
+		}
+	}
 
-			case GAMEPAD_BUTTON_LSTICK_RIGHT:
-				val = GetAxisFloat((Sint32)iIndex, SDL_CONTROLLER_AXIS_LEFTX, true);
-				break;
+	//-----------------------------------------------------------------------------
+	// Purpose: AxisToFloat in Q1.15: the raw value is already one, only the
+	// snap to full past 90% is applied.
+	//-----------------------------------------------------------------------------
+	Sint16 AxisToFixed(const Sint16& iValue)
+	{
+		Sint32 v = iValue;
+		if (v * 10 < -SDL_MAX_SINT16 * 9) return -RINPUT_FIXED_ONE;
+		if (v * 10 > SDL_MAX_SINT16 * 9) return RINPUT_FIXED_ONE;
+		return (Sint16)v;
+	}
 
-			case GAMEPAD_BUTTON_RSTICK_UP:
-				val = -GetAxisFloat((Sint32)iIndex, SDL_CONTROLLER_AXIS_RIGHTY);
-				break;
+	Sint16 AxisButtonFixed(const Uint8& pButton, const Sint16& iRaw)
+	{
+		int iAxis = GetAxisButtonAxis(pButton);
+		if (iAxis < 0) return 0;
+
+		switch (pButton)
+		{
+		case GAMEPAD_BUTTON_LSTICK_UP:
+		case GAMEPAD_BUTTON_LSTICK_LEFT:
+		case GAMEPAD_BUTTON_RSTICK_UP:
+		case GAMEPAD_BUTTON_RSTICK_LEFT:
+		{
+			// -32768 has no positive twin; it snaps to full anyway.
+			Sint32 v = -(Sint32)AxisToFixed(ShapeAxis(iRaw, (Uint32)iAxis, false));
+			return (Sint16)(v > RINPUT_FIXED_ONE ? RINPUT_FIXED_ONE : v);
+		}
 
-			case GAMEPAD_BUTTON_RSTICK_DOWN:
-				val = GetAxisFloat((Sint32)iIndex, SDL_CONTROLLER_AXIS_RIGHTY, true);
-				break;
+		case GAMEPAD_BUTTON_LSTICK_DOWN:
+		case GAMEPAD_BUTTON_LSTICK_RIGHT:
+		case GAMEPAD_BUTTON_RSTICK_DOWN:
+		case GAMEPAD_BUTTON_RSTICK_RIGHT:
+			return AxisToFixed(ShapeAxis(iRaw, (Uint32)iAxis, true));
 
-			case GAMEPAD_BUTTON_RSTICK_LEFT:
-				val = -GetAxisFloat((Sint32)iIndex, SDL_CONTROLLER_AXIS_RIGHTX);
-				break;
+		default:
+			return AxisToFixed(ShapeAxis(iRaw, (Uint32)iAxis, false));
+		}
+	}
 
-			case GAMEPAD_BUTTON_RSTICK_RIGHT:
-				val = GetAxisFloat((Sint32)iIndex, SDL_CONTROLLER_AXIS_RIGHTX, true);
-				break;
+	//-----------------------------------------------------------------------------
+	// Purpose: Return if the button is currently down.
+	//-----------------------------------------------------------------------------
+	float ButtonDown(const Uint8& pButton, const GamePadIndex& iIndex)
+	{
+		float val = 0.0f;
+		if (!IsPortLive((Sint32)iIndex)) return val;
 
-			default:
-				break;
+		if (pButton >= SDL_CONTROLLER_BUTTON_MAX)
+		{
+			int iAxis = GetAxisButtonAxis(pButton);
+			if (iAxis >= 0)
+			{
+				val = AxisButtonValue(pButton, GetAxisRaw((Sint32)iIndex, (Uint32)iAxis));
 			}
 		}
 		else
 		{
-			val = (float)m_arrayControllers[(Sint32)iIndex].mControllerButtons[pButton];
+			val = (float)rinput_context->m_arrayControllers[(Sint32)iIndex].bButtons[pButton];
 		}
 
 		return val;
 	}
 
+	Sint16 ButtonDownFixed(const Uint8& pButton, const GamePadIndex& iIndex)
+	{
+		if (!IsPortLive((Sint32)iIndex)) return 0;
+
+		if (pButton >= SDL_CONTROLLER_BUTTON_MAX)
+		{
+			int iAxis = GetAxisButtonAxis(pButton);
+			if (iAxis < 0) return 0;
+
+			return AxisButtonFixed(pButton, GetAxisRaw((Sint32)iIndex, (Uint32)iAxis));
+		}
+
+		return rinput_context->m_arrayControllers[(Sint32)iIndex].bButtons[pButton] ? RINPUT_FIXED_ONE : 0;
+	}
+
 	//-----------------------------------------------------------------------------
 	// Purpose: Get the string name of the button.
 	//-----------------------------------------------------------------------------
@@ -217,17 +390,26 @@ namespace RInput_GamePad
 	/*
 	const double GetAnalogThreshold(const Sint32& pWhich, const SDL_GameControllerAxis& pAxis)
 	{
-	Sint16 ltv = SDL_GameControllerGetAxis(m_arrayControllers[pWhich].controller, pAxis);
+	Sint16 ltv = SDL_GameControllerGetAxis(rinput_context->m_arrayControllers[pWhich].controller, pAxis);
 	return fmin(1.0, fmax(ltv, 0.0));
 	}
 	*/
 
 	//-----------------------------------------------------------------------------
 	// Purpose: Get the axis value aiding in turning the axis' into buttons.
+	// Reads the last event (or injected) value, not the live device.
 	//-----------------------------------------------------------------------------
 	Sint16 GetAxisValue(const Sint32& pWhich, const Uint32& pAxis, bool bFlip)
 	{
-		Sint16 val = SDL_GameControllerGetAxis(m_arrayControllers[pWhich].controller, (SDL_GameControllerAxis)pAxis);
+		return ShapeAxis(GetAxisRaw(pWhich, pAxis), pAxis, bFlip);
+	}
+
+	//-----------------------------------------------------------------------------
+	// Purpose: Apply the trigger threshold and the left stick's one-sided
+	// deadzone to a raw axis reading.
+	//-----------------------------------------------------------------------------
+	Sint16 ShapeAxis(Sint16 val, const Uint32& pAxis, bool bFlip)
+	{
 		if (pAxis == SDL_CONTROLLER_AXIS_TRIGGERLEFT)
 		{
 			if (val < GAMEPAD_TRIGGER_THRESHOLD)
@@ -284,13 +466,109 @@ namespace RInput_GamePad
 		return val;
 	}
 
+	//-----------------------------------------------------------------------------
+	// Purpose: The axis as last reported by an event, without any deadzone.
+	//-----------------------------------------------------------------------------
+	Sint16 GetAxisRaw(const Sint32& pWhich, const Uint32& pAxis)
+	{
+		if (pWhich < 0 || pWhich > ENUM_GAMEPAD_MAX || pAxis >= SDL_CONTROLLER_AXIS_MAX) return 0;
+		return rinput_context->iAxisRaw[pWhich][pAxis];
+	}
+
+	//-----------------------------------------------------------------------------
+	// Purpose: Stick position with a radial deadzone, rescaled to 0-1 and
+	// put through the response curve (fCurve 1 is linear).
+	//-----------------------------------------------------------------------------
+	void GetStickCurved(const Sint32& pWhich, const Sint8& pStick, const float& fCurve, float& x, float& y)
+	{
+		Uint32 ax = (pStick == GAMEPAD_AXIS_LSTICK) ? SDL_CONTROLLER_AXIS_LEFTX : SDL_CONTROLLER_AXIS_RIGHTX;
+		Uint32 ay = (pStick == GAMEPAD_AXIS_LSTICK) ? SDL_CONTROLLER_AXIS_LEFTY : SDL_CONTROLLER_AXIS_RIGHTY;
+
+		float fx = (float)GetAxisRaw(pWhich, ax) / (float)SDL_MAX_SINT16;
+		float fy = (float)GetAxisRaw(pWhich, ay) / (float)SDL_MAX_SINT16;
+		float fDeadzone = (float)GAMEPAD_THUMB_DEADZONE / (float)SDL_MAX_SINT16;
+
+		float m = sqrtf(fx * fx + fy * fy);
+		if (m <= fDeadzone)
+		{
+			x = y = 0.0f;
+			return;
+		}
+
+		float n = (m - fDeadzone) / (1.0f - fDeadzone);
+		if (n > 1.0f) n = 1.0f;
+		float scale = powf(n, fCurve) / m;
+
+		x = fx * scale;
+		y = fy * scale;
+	}
+
+	Uint32 _ISqrt(Uint32 v)
+	{
+		Uint32 r = 0;
+		Uint32 bit = 1u << 30;
+		while (bit > v) bit >>= 2;
+
+		while (bit != 0)
+		{
+			if (v >= r + bit)
+			{
+				v -= r + bit;
+				r = (r >> 1) + bit;
+			}
+			else
+			{
+				r >>= 1;
+			}
+			bit >>= 2;
+		}
+
+		return r;
+	}
+
+	//-----------------------------------------------------------------------------
+	// Purpose: GetStickCurved in Q1.15 with integer math only.
+	//-----------------------------------------------------------------------------
+	void GetStickCurvedFixed(const Sint32& pWhich, const Sint8& pStick, const Uint8& iCurve, Sint16& x, Sint16& y)
+	{
+		Uint32 ax = (pStick == GAMEPAD_AXIS_LSTICK) ? SDL_CONTROLLER_AXIS_LEFTX : SDL_CONTROLLER_AXIS_RIGHTX;
+		Uint32 ay = (pStick == GAMEPAD_AXIS_LSTICK) ? SDL_CONTROLLER_AXIS_LEFTY : SDL_CONTROLLER_AXIS_RIGHTY;
+
+		Sint32 fx = GetAxisRaw(pWhich, ax);
+		Sint32 fy = GetAxisRaw(pWhich, ay);
+		Sint32 m = (Sint32)_ISqrt((Uint32)(fx * fx) + (Uint32)(fy * fy));
+		if (m <= GAMEPAD_THUMB_DEADZONE)
+		{
+			x = y = 0;
+			return;
+		}
+
+		Sint32 n = (Sint32)((Sint64)(m - GAMEPAD_THUMB_DEADZONE) * RINPUT_FIXED_ONE / (RINPUT_FIXED_ONE - GAMEPAD_THUMB_DEADZONE));
+		if (n > RINPUT_FIXED_ONE) n = RINPUT_FIXED_ONE;
+
+		Sint32 c = n;
+		for (Uint8 i = 1; i < iCurve; i++)
+		{
+			c = (Sint32)(((Sint64)c * n + RINPUT_FIXED_ONE / 2) / RINPUT_FIXED_ONE);
+		}
+
+		Sint64 sx = (Sint64)fx * c / m;
+		Sint64 sy = (Sint64)fy * c / m;
+		x = (Sint16)(sx < -RINPUT_FIXED_ONE ? -RINPUT_FIXED_ONE : (sx > RINPUT_FIXED_ONE ? RINPUT_FIXED_ONE : sx));
+		y = (Sint16)(sy < -RINPUT_FIXED_ONE ? -RINPUT_FIXED_ONE : (sy > RINPUT_FIXED_ONE ? RINPUT_FIXED_ONE : sy));
+	}
+
 	//-----------------------------------------------------------------------------
 	// Purpose: Returns a min of -1.0 or max of 1.0.
 	//-----------------------------------------------------------------------------
 	const float GetAxisFloat(const Sint32& pWhich, const Uint32& pAxis, bool bFlip)
 	{
-		Sint16 ltv = GetAxisValue(pWhich, pAxis, bFlip);
-		float perc = (float)ltv / (float)SDL_MAX_SINT16;
+		return AxisToFloat(GetAxisValue(pWhich, pAxis, bFlip));
+	}
+
+	float AxisToFloat(const Sint16& iValue)
+	{
+		float perc = (float)iValue / (float)SDL_MAX_SINT16;
 		if (perc < -0.9) perc = -1.0;
 		if (perc > 0.9) perc = 1.0;
 		//printf("%f\n", perc);
@@ -304,9 +582,24 @@ namespace RInput_GamePad
 	{
 		if (pWhich <= ENUM_GAMEPAD_MAX)
 		{
-			if (m_arrayControllers[pWhich].controller != nullptr)
+			if (rinput_context->m_arrayControllers[pWhich].controller != nullptr || rinput_context->m_arrayControllers[pWhich].bVirtual)
 			{
-				m_arrayControllers[pWhich].mControllerButtons.clear();
+				// Stamp held buttons released and drop the press times, so
+				// buffered presses and chords don't survive the flush.
+				Uint32 t = SDL_GetTicks();
+				if (t == 0) t = 1;
+
+				for (Uint8 i = 0; i < GAMEPAD_BUTTON_COUNT; i++)
+				{
+					bool bHeld = rinput_context->bAxisButtons[pWhich][i];
+					if (i < SDL_CONTROLLER_BUTTON_MAX) bHeld = bHeld || rinput_context->m_arrayControllers[pWhich].bButtons[i];
+					if (bHeld) rinput_context->iReleaseTime[pWhich][i] = t;
+				}
+
+				memset(rinput_context->m_arrayControllers[pWhich].bButtons, 0, sizeof(rinput_context->m_arrayControllers[pWhich].bButtons));
+				memset(rinput_context->bAxisButtons[pWhich], 0, sizeof(rinput_context->bAxisButtons[pWhich]));
+				memset(rinput_context->iPressTime[pWhich], 0, sizeof(rinput_context->iPressTime[pWhich]));
+				memset(rinput_context->iAxisRaw[pWhich], 0, sizeof(rinput_context->iAxisRaw[pWhich]));
 			}
 		}
 	}
@@ -316,9 +609,9 @@ namespace RInput_GamePad
 	//-----------------------------------------------------------------------------
 	void FlushAll()
 	{
-		SDL_FlushEvent(actioncontroller_event.type == SDL_CONTROLLERBUTTONDOWN);
-		SDL_FlushEvent(actioncontroller_event.type == SDL_CONTROLLERBUTTONUP);
-		SDL_FlushEvent(actioncontroller_event.type == SDL_JOYAXISMOTION);
+		SDL_FlushEvent(rinput_context->event.type == SDL_CONTROLLERBUTTONDOWN);
+		SDL_FlushEvent(rinput_context->event.type == SDL_CONTROLLERBUTTONUP);
+		SDL_FlushEvent(rinput_context->event.type == SDL_JOYAXISMOTION);
 
 		for (Sint32 i = 0; i < ENUM_GAMEPAD_MAX; i++)
 		{
@@ -0,0 +1,254 @@
+/*
+MIT License
+
+Copyright (c) 2019 Reep Softworks
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+
+#include <vector>
+#include <string>
+#include "rinput.h"
+#include "context.h"
+
+namespace RInput
+{
+	int GetHapticIndex(const std::string& pHapticName)
+	{
+		for (size_t i = 0; i < rinput_context->vHaptics.size(); i++)
+		{
+			if (rinput_context->vHaptics[i].name == pHapticName) return (int)i;
+		}
+
+		return -1;
+	}
+
+	//-----------------------------------------------------------------------------
+	// Purpose: Register (or replace) a pattern. Keys must be in time order;
+	// the motors are interpolated between them. Returns its index.
+	//-----------------------------------------------------------------------------
+	int RegisterHaptic(const std::string& pHapticName, const haptickey_t* pKeys, Uint16 iCount, bool bLoop)
+	{
+		if (pKeys == NULL || iCount == 0) return -1;
+
+		for (Uint16 i = 1; i < iCount; i++)
+		{
+			if (pKeys[i].time < pKeys[i - 1].time)
+			{
+				printf("Error: Haptic '%s' keys are out of order.\n", pHapticName.c_str());
+				return -1;
+			}
+		}
+
+		int h = GetHapticIndex(pHapticName);
+		if (h < 0)
+		{
+			haptic_t n;
+			n.name = pHapticName;
+			n.iFirst = (Uint32)rinput_context->vHapticKeys.size();
+			n.iCount = 0;
+			rinput_context->vHaptics.push_back(n);
+			h = (int)rinput_context->vHaptics.size() - 1;
+		}
+
+		// Swap the old keys for the new ones and shift everything stored after.
+		haptic_t& hp = rinput_context->vHaptics[h];
+		std::vector<haptickey_t>::iterator at = rinput_context->vHapticKeys.begin() + hp.iFirst;
+		at = rinput_context->vHapticKeys.erase(at, at + hp.iCount);
+		rinput_context->vHapticKeys.insert(at, pKeys, pKeys + iCount);
+
+		Sint32 iShift = (Sint32)iCount - (Sint32)hp.iCount;
+		for (size_t i = 0; i < rinput_context->vHaptics.size(); i++)
+		{
+			if (rinput_context->vHaptics[i].iFirst > hp.iFirst) rinput_context->vHaptics[i].iFirst += iShift;
+		}
+
+		hp.iCount = iCount;
+		hp.iLength = pKeys[iCount - 1].time;
+		hp.bLoop = bLoop;
+		return h;
+	}
+
+	//-----------------------------------------------------------------------------
+	// Purpose: Attack/sustain/decay envelope: ramps up to the levels over
+	// iAttack ms, holds for iSustain and fades out over iDecay.
+	//-----------------------------------------------------------------------------
+	int RegisterHapticEnvelope(const std::string& pHapticName, Uint16 iLeftMotor, Uint16 iRightMotor, Uint32 iAttack, Uint32 iSustain, Uint32 iDecay)
+	{
+		haptickey_t keys[4];
+		keys[0].time = 0;
+		keys[0].left = keys[0].right = 0;
+		keys[1].time = iAttack;
+		keys[1].left = iLeftMotor;
+		keys[1].right = iRightMotor;
+		keys[2].time = iAttack + iSustain;
+		keys[2].left = iLeftMotor;
+		keys[2].right = iRightMotor;
+		keys[3].time = iAttack + iSustain + iDecay;
+		keys[3].left = keys[3].right = 0;
+
+		// An instant attack starts at full strength.
+		if (iAttack == 0) return RegisterHaptic(pHapticName, keys + 1, 3, false);
+		return RegisterHaptic(pHapticName, keys, 4, false);
+	}
+
+	int GetHapticCount()
+	{
+		return (int)rinput_context->vHaptics.size();
+	}
+
+	const char* GetHapticName(const int iHaptic)
+	{
+		if (iHaptic < 0 || iHaptic >= (int)rinput_context->vHaptics.size()) return "";
+		return rinput_context->vHaptics[iHaptic].name.c_str();
+	}
+
+	//-----------------------------------------------------------------------------
+	// Purpose: A pattern's keys, e.g. for writing them back out.
+	//-----------------------------------------------------------------------------
+	bool GetHapticKeys(const int iHaptic, const haptickey_t*& pKeys, Uint16& iCount, bool& bLoop)
+	{
+		if (iHaptic < 0 || iHaptic >= (int)rinput_context->vHaptics.size()) return false;
+
+		const haptic_t& hp = rinput_context->vHaptics[iHaptic];
+		pKeys = rinput_context->vHapticKeys.empty() ? NULL : &rinput_context->vHapticKeys[hp.iFirst];
+		iCount = hp.iCount;
+		bLoop = hp.bLoop;
+		return true;
+	}
+
+#ifndef RINPUT_NO_RUMBLE
+	//-----------------------------------------------------------------------------
+	// Purpose: Start a pattern on a pad (or CONTROLLER_PORT_ALL). Returns a
+	// handle for StopHaptic, or -1 if every slot holds something more
+	// important.
+	//-----------------------------------------------------------------------------
+	int PlayHaptic(const int pPort, const int iHaptic, Uint8 iPriority)
+	{
+		if (iHaptic < 0 || iHaptic >= (int)rinput_context->vHaptics.size()) return -1;
+
+		if (!rinput_context->haptic_playing_init)
+		{
+			for (int i = 0; i < HAPTIC_MAX_PLAYING; i++) rinput_context->haptic_playing[i].id = -1;
+			rinput_context->haptic_playing_init = true;
+		}
+
+		int id = rinput_context->haptic_next_id++;
+		if (rinput_context->haptic_next_id < 0) rinput_context->haptic_next_id = 0;
+
+		bool bQueued = false;
+		for (int p = 0; p <= RInput_GamePad::ENUM_GAMEPAD_MAX; p++)
+		{
+			if (pPort != CONTROLLER_PORT_ALL && pPort != p) continue;
+
+			int slot = -1;
+			for (int i = 0; i < HAPTIC_MAX_PLAYING; i++)
+			{
+				if (rinput_context->haptic_playing[i].id < 0)
+				{
+					slot = i;
+					break;
+				}
+
+				if (rinput_context->haptic_playing[i].priority <= iPriority && (slot < 0 || rinput_context->haptic_playing[i].priority < rinput_context->haptic_playing[slot].priority))
+				{
+					slot = i;
+				}
+			}
+
+			if (slot < 0) continue;
+
+			hapticplay_t& h = rinput_context->haptic_playing[slot];
+			h.id = id;
+			h.haptic = (Sint16)iHaptic;
+			h.port = (Uint8)p;
+			h.priority = iPriority;
+			h.iKey = 0;
+			h.iStart = SDL_GetTicks();
+			bQueued = true;
+		}
+
+		return bQueued ? id : -1;
+	}
+
+	int PlayHaptic(const int pPort, const std::string& pHapticName, Uint8 iPriority)
+	{
+		return PlayHaptic(pPort, GetHapticIndex(pHapticName), iPriority);
+	}
+
+	void StopHaptic(const int iPlaying)
+	{
+		if (iPlaying < 0 || !rinput_context->haptic_playing_init) return;
+
+		for (int i = 0; i < HAPTIC_MAX_PLAYING; i++)
+		{
+			if (rinput_context->haptic_playing[i].id == iPlaying) rinput_context->haptic_playing[i].id = -1;
+		}
+	}
+
+	//-----------------------------------------------------------------------------
+	// Purpose: Sample every playing pattern in one pass, raising each pad's
+	// motor levels to at least the pattern's value.
+	//-----------------------------------------------------------------------------
+	void SampleHaptics(const Uint32 iNow, Uint16* pLeft, Uint16* pRight)
+	{
+		if (!rinput_context->haptic_playing_init) return;
+
+		for (int i = 0; i < HAPTIC_MAX_PLAYING; i++)
+		{
+			hapticplay_t& h = rinput_context->haptic_playing[i];
+			if (h.id < 0) continue;
+
+			const haptic_t& hp = rinput_context->vHaptics[h.haptic];
+			const haptickey_t* keys = &rinput_context->vHapticKeys[hp.iFirst];
+
+			Uint32 t = iNow - h.iStart;
+			if (t >= hp.iLength)
+			{
+				if (!hp.bLoop || hp.iLength == 0)
+				{
+					h.id = -1;
+					continue;
+				}
+
+				t %= hp.iLength;
+			}
+
+			if (h.iKey >= hp.iCount || t < keys[h.iKey].time) h.iKey = 0; // Wrapped around, or replaced.
+			while (h.iKey + 1 < hp.iCount && keys[h.iKey + 1].time <= t) h.iKey++;
+
+			Uint16 left = keys[h.iKey].left;
+			Uint16 right = keys[h.iKey].right;
+			// Before the first key (or after a loop wraps below it), hold its levels.
+			if (h.iKey + 1 < hp.iCount && t >= keys[0].time)
+			{
+				const haptickey_t& a = keys[h.iKey];
+				const haptickey_t& b = keys[h.iKey + 1];
+				float f = (float)(t - a.time) / (float)(b.time - a.time);
+				left = (Uint16)(a.left + (b.left - a.left) * f);
+				right = (Uint16)(a.right + (b.right - a.right) * f);
+			}
+
+			if (left > pLeft[h.port]) pLeft[h.port] = left;
+			if (right > pRight[h.port]) pRight[h.port] = right;
+		}
+	}
+#endif // RINPUT_NO_RUMBLE
+}
@@ -0,0 +1,158 @@
+/*
+MIT License
+
+Copyright (c) 2019 Reep Softworks
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#include <vector>
+#include <string>
+#include "rinput.h"
+#include "context.h"
+
+namespace RInput
+{
+	//-----------------------------------------------------------------------------
+	// Purpose: The SDL button behind a mouse button code, 0 if it isn't one.
+	//-----------------------------------------------------------------------------
+	Uint8 _InjectMouseButton(const Sint32& pCode)
+	{
+		if (pCode == MOUSE_BUTTON_LEFT) return SDL_BUTTON_LEFT;
+		if (pCode == MOUSE_BUTTON_MIDDLE) return SDL_BUTTON_MIDDLE;
+		if (pCode == MOUSE_BUTTON_RIGHT) return SDL_BUTTON_RIGHT;
+		if (pCode == MOUSE_BUTTON_X1) return SDL_BUTTON_X1;
+		if (pCode == MOUSE_BUTTON_X2) return SDL_BUTTON_X2;
+		return 0;
+	}
+
+	bool _InjectKM(const inputrecord_t& r, const Uint32 t)
+	{
+		switch (r.code)
+		{
+		case INPUT_MOUSE_MOTION_X:
+			RInput_KM::AddMouseMotion(r.value, 0);
+			return true;
+
+		case INPUT_MOUSE_MOTION_Y:
+			RInput_KM::AddMouseMotion(0, r.value);
+			return true;
+
+		case MOUSE_BUTTON_WHEELUP:
+			RInput_KM::AddMouseWheel(r.value, (float)r.value);
+			return true;
+
+		case MOUSE_BUTTON_WHEELDOWN:
+			RInput_KM::AddMouseWheel(-r.value, -(float)r.value);
+			return true;
+
+		default:
+			break;
+		}
+
+		if (r.code < 0) return false;
+
+		Uint8 b = _InjectMouseButton(r.code);
+		if (b != 0)
+		{
+			RInput_KM::SimulateMouseButton(b, r.value != 0, t);
+			return true;
+		}
+
+		// Like the events, a key already down isn't a new combo input.
+		bool bDown = r.value != 0;
+		if (bDown != (RInput_KM::ButtonDown(r.code) > 0.0f)) _ComboKey(r.code, bDown, t);
+		RInput_KM::SimulateButton(r.code, bDown, t);
+		return true;
+	}
+
+	bool _InjectGamePad(const inputrecord_t& r, const Sint32& iPort, const Uint32 t)
+	{
+		bool bAxis = r.code >= GAMEPAD_INPUT_AXIS(0) && r.code < GAMEPAD_INPUT_AXIS(SDL_CONTROLLER_AXIS_MAX);
+		if (!bAxis && (r.code < 0 || r.code >= SDL_CONTROLLER_BUTTON_MAX)) return false;
+
+		// An empty port becomes a virtual pad holding what's injected.
+		RInput_GamePad::gamepad_t& pad = rinput_context->m_arrayControllers[iPort];
+		if (!RInput_GamePad::IsPortLive(iPort)) pad.bVirtual = true;
+
+		if (bAxis)
+		{
+			Uint32 axis = (Uint32)(r.code - GAMEPAD_INPUT_AXIS(0));
+			_ComboPadAxis(iPort, axis, r.value, t);
+			RInput_GamePad::UpdateAxisMotions(iPort, axis, r.value, t);
+			return true;
+		}
+
+		bool bDown = r.value != 0;
+		if (bDown != pad.bButtons[r.code]) _ComboPadButton(iPort, (Uint8)r.code, bDown, t);
+		RInput_GamePad::SimulateButton(iPort, (Uint8)r.code, bDown, t);
+		return true;
+	}
+
+	//-----------------------------------------------------------------------------
+	// Purpose: Apply a batch of records in order, as TestEvents would apply
+	// the matching events. The active device follows the last record that
+	// would have switched it. Records with bad codes or ports are skipped
+	// and left out of the count.
+	//-----------------------------------------------------------------------------
+	size_t InjectInputs(const inputrecord_t* pRecords, const size_t iCount, const Sint32 iPort)
+	{
+		if (pRecords == NULL || iCount == 0) return 0;
+
+		Uint32 now = SDL_GetTicks();
+		if (now == 0) now = 1;
+
+		bool bPortValid = iPort >= 0 && iPort <= RInput_GamePad::ENUM_GAMEPAD_MAX;
+		int device = -1;
+		size_t applied = 0;
+
+		for (size_t i = 0; i < iCount; i++)
+		{
+			const inputrecord_t& r = pRecords[i];
+			Uint32 t = r.timestamp != 0 ? r.timestamp : now;
+
+			if (r.device == CONTROLLER_KEYBOARDMOUSE)
+			{
+				if (!_InjectKM(r, t)) continue;
+
+				// Only buttons wake the keyboard, like the events.
+				if (r.code >= 0 && r.code != MOUSE_BUTTON_WHEELUP && r.code != MOUSE_BUTTON_WHEELDOWN)
+				{
+					device = CONTROLLER_KEYBOARDMOUSE;
+					_InteractionEdge(CONTROLLER_KEYBOARDMOUSE, t);
+				}
+			}
+			else if (r.device == CONTROLLER_GAMEPAD && bPortValid)
+			{
+				if (!_InjectGamePad(r, iPort, t)) continue;
+				device = CONTROLLER_GAMEPAD;
+				_InteractionEdge(CONTROLLER_GAMEPAD, t);
+			}
+			else
+			{
+				continue;
+			}
+
+			applied++;
+		}
+
+		if (device >= 0) SetActiveDevice((Controllers_t)device);
+		return applied;
+	}
+}
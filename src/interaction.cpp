@@ -0,0 +1,198 @@
+/*
+MIT License
+
+Copyright (c) 2019 Reep Softworks
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#include <vector>
+#include <string>
+#include "rinput.h"
+#include "context.h"
+
+namespace RInput
+{
+	//-----------------------------------------------------------------------------
+	// Purpose: Attach an interaction to an action. Returns its index.
+	//-----------------------------------------------------------------------------
+	int AddInteraction(const std::string& pActionName, const Interaction_t& pType, const Uint32 iMs)
+	{
+		interaction_t it;
+		it.pAction = &GetAction(pActionName);
+		it.iMs = iMs;
+		it.iSeen = _ActionPressTime(*it.pAction);
+		it.iStart = 0;
+		it.iLastTap = 0;
+		it.type = (Uint8)pType;
+		it.bHeld = false;
+		it.bFired = false;
+		it.bActive = false;
+		it.bTriggered = false;
+		it.bPending = false;
+
+		rinput_context->vInteractions.push_back(it);
+		return (int)rinput_context->vInteractions.size() - 1;
+	}
+
+	void _InteractionPress(interaction_t& it, const Uint32 t)
+	{
+		it.bHeld = true;
+		it.bFired = false;
+		it.iStart = t;
+
+		switch (it.type)
+		{
+		case INTERACTION_DOUBLETAP:
+			if (it.iLastTap != 0 && t - it.iLastTap <= it.iMs)
+			{
+				it.bPending = true;
+				it.iLastTap = 0;
+			}
+			else
+			{
+				it.iLastTap = t;
+			}
+			break;
+
+		case INTERACTION_TOGGLE:
+			it.bActive = !it.bActive;
+			it.bPending = true;
+			break;
+
+		default:
+			break;
+		}
+	}
+
+	void _InteractionRelease(interaction_t& it, const Uint32 t)
+	{
+		Uint32 iHeld = t - it.iStart;
+		it.bHeld = false;
+
+		switch (it.type)
+		{
+		case INTERACTION_TAP:
+			if (iHeld < it.iMs) it.bPending = true;
+			break;
+
+		case INTERACTION_HOLD:
+			it.bActive = false;
+			break;
+
+		case INTERACTION_RELEASEAFTERHOLD:
+			if (iHeld >= it.iMs) it.bPending = true;
+			break;
+
+		default:
+			break;
+		}
+	}
+
+	//-----------------------------------------------------------------------------
+	// Purpose: Step every interaction on a button edge from device. Two taps,
+	// or a tap and a press, inside one frame each get stepped here; Update
+	// only sees where the action ended up.
+	//-----------------------------------------------------------------------------
+	void _InteractionEdge(const Uint8 device, const Uint32 t)
+	{
+		if (rinput_context->vInteractions.empty()) return;
+
+		for (std::vector<interaction_t>::iterator it = rinput_context->vInteractions.begin(); it != rinput_context->vInteractions.end(); ++it)
+		{
+			bool bDown = _ActionValueOn(*it->pAction, device) > 0.0f;
+
+			if (bDown && !it->bHeld)
+			{
+				// Mark the press seen so Update doesn't step it again.
+				it->iSeen = _ActionPressTime(*it->pAction);
+				_InteractionPress(*it, t);
+			}
+			else if (!bDown && it->bHeld)
+			{
+				_InteractionRelease(*it, t);
+			}
+		}
+	}
+
+	//-----------------------------------------------------------------------------
+	// Purpose: Step every interaction. Press and release times come from the
+	// event timestamps, so the tap/hold thresholds don't depend on the frame
+	// rate. Presses that didn't come through an event are picked up here.
+	//-----------------------------------------------------------------------------
+	void UpdateInteractions()
+	{
+		if (rinput_context->vInteractions.empty()) return;
+
+		Uint32 now = SDL_GetTicks();
+
+		for (std::vector<interaction_t>::iterator it = rinput_context->vInteractions.begin(); it != rinput_context->vInteractions.end(); ++it)
+		{
+			Uint32 iPress = _ActionPressTime(*it->pAction);
+			bool bDown = _ActionValue(*it->pAction) > 0.0f;
+
+			if (iPress != 0 && iPress != it->iSeen)
+			{
+				it->iSeen = iPress;
+				if (it->bHeld)
+				{
+					// Let go and pressed again since the last frame.
+					Uint32 iRelease = _ActionReleaseTime(*it->pAction);
+					_InteractionRelease(*it, (iRelease >= it->iStart && iRelease <= iPress) ? iRelease : iPress);
+				}
+				_InteractionPress(*it, iPress);
+			}
+
+			if (it->bHeld && !bDown)
+			{
+				Uint32 iRelease = _ActionReleaseTime(*it->pAction);
+				_InteractionRelease(*it, (iRelease >= it->iStart && iRelease != 0) ? iRelease : now);
+			}
+
+			if (it->bHeld && it->type == INTERACTION_HOLD && !it->bFired && now - it->iStart >= it->iMs)
+			{
+				it->bFired = true;
+				it->bActive = true;
+				it->bPending = true;
+			}
+
+			// Anything triggered since the last Update shows this frame.
+			it->bTriggered = it->bPending;
+			it->bPending = false;
+		}
+	}
+
+	//-----------------------------------------------------------------------------
+	// Purpose: Did the interaction happen this frame?
+	//-----------------------------------------------------------------------------
+	bool OnInteraction(const int iInteraction)
+	{
+		if (iInteraction < 0 || iInteraction >= (int)rinput_context->vInteractions.size()) return false;
+		return rinput_context->vInteractions[iInteraction].bTriggered;
+	}
+
+	//-----------------------------------------------------------------------------
+	// Purpose: Is a hold past its time, or a toggle switched on?
+	//-----------------------------------------------------------------------------
+	bool GetInteractionActive(const int iInteraction)
+	{
+		if (iInteraction < 0 || iInteraction >= (int)rinput_context->vInteractions.size()) return false;
+		return rinput_context->vInteractions[iInteraction].bActive;
+	}
+}
@@ -24,25 +24,54 @@ SOFTWARE.
 
 #include <map>
 #include <string>
+#include <string.h>
 #include "rinput.h"
+#include "context.h"
 
 namespace RInput_KM
 {
+	using RInput::rinput_context;
+
 	//-----------------------------------------------------------------------------
-	// Purpose: 
+	// Purpose: Slot of a key in the flat key table, or -1 for mButton.
 	//-----------------------------------------------------------------------------
-	std::map<Sint32, bool> mButton;
-	bool bEnabled;
+	int _KeyStateIndex(const Sint32& pKey)
+	{
+		if (pKey >= 0 && pKey < 128) return pKey;
+		if (pKey & SDLK_SCANCODE_MASK)
+		{
+			Sint32 iScancode = pKey & ~SDLK_SCANCODE_MASK;
+			if (iScancode >= 0 && iScancode < SDL_NUM_SCANCODES) return 128 + iScancode;
+		}
+		return -1;
+	}
 
 	//-----------------------------------------------------------------------------
 	// Purpose: Record the state of the button.
 	//-----------------------------------------------------------------------------
-	void SimulateButton(const Sint32& pKey, bool bDown)
+	void SimulateButton(const Sint32& pKey, bool bDown, const Uint32 iTimestamp)
 	{
-		if (bEnabled == false)
+		if (rinput_context->bEnabled == false)
 			return;
 
-		mButton[pKey] = bDown;
+		int i = _KeyStateIndex(pKey);
+		if (i >= 0)
+		{
+			if (rinput_context->bKeyState[i] != bDown)
+			{
+				Uint32 t = iTimestamp != 0 ? iTimestamp : SDL_GetTicks();
+				if (t == 0) t = 1;
+
+				if (bDown) rinput_context->iKeyPressTime[i] = t;
+				else rinput_context->iKeyReleaseTime[i] = t;
+			}
+
+			rinput_context->bKeyState[i] = bDown;
+		}
+		else
+		{
+			rinput_context->mButton[pKey] = bDown;
+		}
 	}
 
 	//-----------------------------------------------------------------------------
@@ -50,30 +79,48 @@ namespace RInput_KM
 	//-----------------------------------------------------------------------------
 	float ButtonDown(const Sint32& pKey)
 	{
-		if (bEnabled == false) return 0.0f;
+		if (rinput_context->bEnabled == false) return 0.0f;
 
 		if (pKey == MOUSE_BUTTON_WHEELUP) return (float)OnMouseWheelUp();
 		if (pKey == MOUSE_BUTTON_WHEELDOWN) return (float)OnMouseWheelDown();
-		return (float)mButton[pKey];
+		int i = _KeyStateIndex(pKey);
+		if (i >= 0) return (float)rinput_context->bKeyState[i];
+
+		std::map<Sint32, bool>::const_iterator it = rinput_context->mButton.find(pKey);
+		return (it != rinput_context->mButton.end()) ? (float)it->second : 0.0f;
+	}
+
+	//-----------------------------------------------------------------------------
+	// Purpose: When the button last went down/up.
+	//-----------------------------------------------------------------------------
+	Uint32 ButtonPressTime(const Sint32& pKey)
+	{
+		int i = _KeyStateIndex(pKey);
+		return (i >= 0) ? rinput_context->iKeyPressTime[i] : 0;
+	}
+
+	Uint32 ButtonReleaseTime(const Sint32& pKey)
+	{
+		int i = _KeyStateIndex(pKey);
+		return (i >= 0) ? rinput_context->iKeyReleaseTime[i] : 0;
 	}
 
 	//-----------------------------------------------------------------------------
 	// Purpose: Set the mouse position.
 	//-----------------------------------------------------------------------------
-	int mouseX = 0;
-	int mouseY = 0;
 	void SetMousePosition(const int x, const int y, bool bGlobal)
 	{
-		mouseX = x;
-		mouseY = y;
+		rinput_context->mouseX = x;
+		rinput_context->mouseY = y;
+		RINPUT_COUNT(iSDLCalls);
 
 		if (!bGlobal)
 		{
-			SDL_WarpMouseInWindow(actioncontroller_window, mouseX, mouseY);
+			SDL_WarpMouseInWindow(rinput_context->window, rinput_context->mouseX, rinput_context->mouseY);
 		}
 		else
 		{
-			SDL_WarpMouseGlobal(mouseX, mouseY);
+			SDL_WarpMouseGlobal(rinput_context->mouseX, rinput_context->mouseY);
 		}
 	}
 
@@ -92,7 +139,8 @@ namespace RInput_KM
 	//-----------------------------------------------------------------------------
 	void UpdateMousePosition()
 	{
-		SDL_GetMouseState(&mouseX, &mouseY);
+		SDL_GetMouseState(&rinput_context->mouseX, &rinput_context->mouseY);
+		RINPUT_COUNT(iSDLCalls);
 	}
 
 	//-----------------------------------------------------------------------------
@@ -100,12 +148,58 @@ namespace RInput_KM
 	//-----------------------------------------------------------------------------
 	void SimulateMouse(const int x, const int y)
 	{
-		mouseX = x;
-		mouseY = y;
+		rinput_context->mouseX = x;
+		rinput_context->mouseY = y;
+	}
+
+	int GetMouseX() { return rinput_context->mouseX; }
+	int GetMouseY() { return rinput_context->mouseY; }
+
+	//-----------------------------------------------------------------------------
+	// Purpose: Motion from SDL_MOUSEMOTION's xrel/yrel is summed here and
+	// turned into a per-frame delta by UpdateMouseDelta().
+	//-----------------------------------------------------------------------------
+	void AddMouseMotion(const int xrel, const int yrel)
+	{
+		rinput_context->iMotionX += xrel;
+		rinput_context->iMotionY += yrel;
+	}
+
+	void UpdateMouseDelta()
+	{
+		rinput_context->iMouseDeltaX = rinput_context->iMotionX;
+		rinput_context->iMouseDeltaY = rinput_context->iMotionY;
+		rinput_context->iMotionX = 0;
+		rinput_context->iMotionY = 0;
+	}
+
+	void GetMouseDelta(int& x, int& y)
+	{
+		x = rinput_context->iMouseDeltaX;
+		y = rinput_context->iMouseDeltaY;
 	}
 
-	int GetMouseX() { return mouseX; }
-	int GetMouseY() { return mouseY; }
+	int GetMouseDeltaX() { return rinput_context->iMouseDeltaX; }
+	int GetMouseDeltaY() { return rinput_context->iMouseDeltaY; }
+
+	//-----------------------------------------------------------------------------
+	// Purpose: Relative mode hides and locks the cursor; only deltas arrive.
+	//-----------------------------------------------------------------------------
+	bool SetRelativeMouseMode(bool bEnable)
+	{
+		if (SDL_SetRelativeMouseMode(bEnable ? SDL_TRUE : SDL_FALSE) != 0)
+		{
+			printf("Failed to set relative mouse mode! SDL Error: %s\n", SDL_GetError());
+			return false;
+		}
+
+		return true;
+	}
+
+	bool GetRelativeMouseMode()
+	{
+		return SDL_GetRelativeMouseMode() == SDL_TRUE;
+	}
 
 	//-----------------------------------------------------------------------------
 	// Purpose: Show the mouse.
@@ -124,12 +218,84 @@ namespace RInput_KM
 	}
 
 	//-----------------------------------------------------------------------------
-	// Purpose: Set the wheel position.
+	// Purpose: Mouse buttons. Every event lands in the bitmask and, mapped to
+	// its MOUSE_BUTTON_* code, in the key table so it binds like a key.
+	//-----------------------------------------------------------------------------
+	void SimulateMouseButton(const Uint8& pButton, bool bDown, const Uint32 iTimestamp)
+	{
+		if (rinput_context->bEnabled == false)
+			return;
+
+		Sint32 b;
+		switch (pButton)
+		{
+		case SDL_BUTTON_LEFT: b = MOUSE_BUTTON_LEFT; break;
+		case SDL_BUTTON_MIDDLE: b = MOUSE_BUTTON_MIDDLE; break;
+		case SDL_BUTTON_RIGHT: b = MOUSE_BUTTON_RIGHT; break;
+		case SDL_BUTTON_X1: b = MOUSE_BUTTON_X1; break;
+		case SDL_BUTTON_X2: b = MOUSE_BUTTON_X2; break;
+		default: return; // Anything past X2 has no code to bind to.
+		}
+
+		if (bDown) rinput_context->iMouseButtons |= SDL_BUTTON(pButton);
+		else rinput_context->iMouseButtons &= ~SDL_BUTTON(pButton);
+
+		SimulateButton(b, bDown, iTimestamp);
+	}
+
+	Uint32 GetMouseButtonMask()
+	{
+		return rinput_context->iMouseButtons;
+	}
+
+	bool MouseButtonDown(const Uint8& pButton)
+	{
+		if (pButton < SDL_BUTTON_LEFT || pButton > SDL_BUTTON_X2) return false;
+		return (rinput_context->iMouseButtons & SDL_BUTTON(pButton)) != 0;
+	}
+
+	//-----------------------------------------------------------------------------
+	// Purpose: Wheel events are summed here and turned into a per-frame
+	// delta by UpdateMouseWheel(), so fast scrolling doesn't drop ticks and
+	// any number of readers see the same value.
+	//-----------------------------------------------------------------------------
+	void AddMouseWheel(const int y, const float fPreciseY)
+	{
+		rinput_context->iWheelAccum += y;
+		rinput_context->fWheelAccum += fPreciseY;
+	}
+
+	void UpdateMouseWheel()
+	{
+		rinput_context->bWheelFrames = true;
+		rinput_context->iWheelDelta = rinput_context->iWheelAccum;
+		rinput_context->fWheelDelta = rinput_context->fWheelAccum;
+		rinput_context->iWheelAccum = 0;
+		rinput_context->fWheelAccum = 0.0f;
+	}
+
+	int GetMouseWheelDelta() { return rinput_context->iWheelDelta; }
+	float GetMouseWheelDeltaPrecise() { return rinput_context->fWheelDelta; }
+
+	//-----------------------------------------------------------------------------
+	// Purpose: Add whole wheel ticks, for callers without the precise value.
 	//-----------------------------------------------------------------------------
-	int iMouseWheelPos = 0;
 	void SetMouseWheelPosition(const int y)
 	{
-		iMouseWheelPos = y;
+		AddMouseWheel(y, (float)y);
+	}
+
+	//-----------------------------------------------------------------------------
+	// Purpose: Without Update() there are no frames to hand out a delta, so
+	// the wheel latches from the events until it's read, as it used to.
+	//-----------------------------------------------------------------------------
+	bool _TakeLatchedWheel(const int iSign)
+	{
+		if (rinput_context->iWheelAccum * iSign <= 0) return false;
+
+		rinput_context->iWheelAccum = 0;
+		rinput_context->fWheelAccum = 0.0f;
+		return true;
 	}
 
 	//-----------------------------------------------------------------------------
@@ -137,14 +303,8 @@ namespace RInput_KM
 	//-----------------------------------------------------------------------------
 	bool OnMouseWheelUp()
 	{
-		bool b = false;
-		if (iMouseWheelPos >= 1)
-		{
-			b = true;
-			iMouseWheelPos = 0;
-		}
-
-		return b;
+		if (!rinput_context->bWheelFrames) return _TakeLatchedWheel(1);
+		return rinput_context->iWheelDelta > 0;
 	}
 
 	//-----------------------------------------------------------------------------
@@ -152,14 +312,8 @@ namespace RInput_KM
 	//-----------------------------------------------------------------------------
 	bool OnMouseWheelDown()
 	{
-		bool b = false;
-		if (iMouseWheelPos < 0)
-		{
-			b = true;
-			iMouseWheelPos = 0;
-		}
-
-		return b;
+		if (!rinput_context->bWheelFrames) return _TakeLatchedWheel(-1);
+		return rinput_context->iWheelDelta < 0;
 	}
 
 	//-----------------------------------------------------------------------------
@@ -170,6 +324,8 @@ namespace RInput_KM
 		if (pButton == MOUSE_BUTTON_LEFT) return MOUSE_BUTTON_LEFT_NAME;
 		if (pButton == MOUSE_BUTTON_MIDDLE) return MOUSE_BUTTON_MIDDLE_NAME;
 		if (pButton == MOUSE_BUTTON_RIGHT) return MOUSE_BUTTON_RIGHT_NAME;
+		if (pButton == MOUSE_BUTTON_X1) return MOUSE_BUTTON_X1_NAME;
+		if (pButton == MOUSE_BUTTON_X2) return MOUSE_BUTTON_X2_NAME;
 
 		if (pButton == MOUSE_BUTTON_WHEELUP) return MOUSE_BUTTON_WHEELUP_NAME;
 		if (pButton == MOUSE_BUTTON_WHEELDOWN) return MOUSE_BUTTON_WHEELDOWN_NAME;
@@ -186,6 +342,8 @@ namespace RInput_KM
 		if (s == MOUSE_BUTTON_LEFT_NAME) return MOUSE_BUTTON_LEFT;
 		if (s == MOUSE_BUTTON_MIDDLE_NAME) return MOUSE_BUTTON_MIDDLE;
 		if (s == MOUSE_BUTTON_RIGHT_NAME) return MOUSE_BUTTON_RIGHT;
+		if (s == MOUSE_BUTTON_X1_NAME) return MOUSE_BUTTON_X1;
+		if (s == MOUSE_BUTTON_X2_NAME) return MOUSE_BUTTON_X2;
 
 		if (s == MOUSE_BUTTON_WHEELUP_NAME) return MOUSE_BUTTON_WHEELUP;
 		if (s == MOUSE_BUTTON_WHEELDOWN_NAME) return MOUSE_BUTTON_WHEELDOWN;
@@ -197,17 +355,36 @@ namespace RInput_KM
 	//-----------------------------------------------------------------------------
 	// Purpose: Toggle the allowence of the keyboard and mouse.
 	//-----------------------------------------------------------------------------
-	void Enable()	{ bEnabled = true;  }
-	void Disable()	{ bEnabled = false; }
+	void Enable()	{ rinput_context->bEnabled = true;  }
+	void Disable()	{ rinput_context->bEnabled = false; }
+
+	//-----------------------------------------------------------------------------
+	// Purpose: Let go of every key. Held keys are stamped released and the
+	// press times dropped, so buffered presses and chords don't survive it.
+	//-----------------------------------------------------------------------------
+	void _FlushKeyState()
+	{
+		Uint32 t = SDL_GetTicks();
+		if (t == 0) t = 1;
+
+		for (int i = 0; i < RINPUT_KEYSTATE_SIZE; i++)
+		{
+			if (rinput_context->bKeyState[i]) rinput_context->iKeyReleaseTime[i] = t;
+		}
+
+		memset(rinput_context->bKeyState, 0, sizeof(rinput_context->bKeyState));
+		memset(rinput_context->iKeyPressTime, 0, sizeof(rinput_context->iKeyPressTime));
+		rinput_context->mButton.clear();
+	}
 
 	//-----------------------------------------------------------------------------
 	// Purpose: Flush only the keyboard.
 	//-----------------------------------------------------------------------------
 	void FlushKeyboard()
 	{
-		SDL_FlushEvent(actioncontroller_event.type == SDL_MOUSEBUTTONDOWN);
-		SDL_FlushEvent(actioncontroller_event.type == SDL_MOUSEBUTTONUP);
-		mButton.clear();
+		SDL_FlushEvent(rinput_context->event.type == SDL_MOUSEBUTTONDOWN);
+		SDL_FlushEvent(rinput_context->event.type == SDL_MOUSEBUTTONUP);
+		_FlushKeyState();
 	}
 
 	//-----------------------------------------------------------------------------
@@ -215,9 +392,14 @@ namespace RInput_KM
 	//-----------------------------------------------------------------------------
 	void FlushMouse()
 	{
-		SDL_FlushEvent(actioncontroller_event.type == SDL_KEYDOWN);
-		SDL_FlushEvent(actioncontroller_event.type == SDL_KEYUP);
-		mButton.clear();
+		rinput_context->iMotionX = rinput_context->iMotionY = 0;
+		rinput_context->iMouseDeltaX = rinput_context->iMouseDeltaY = 0;
+		rinput_context->iWheelAccum = rinput_context->iWheelDelta = 0;
+		rinput_context->fWheelAccum = rinput_context->fWheelDelta = 0.0f;
+		rinput_context->iMouseButtons = 0;
+		SDL_FlushEvent(rinput_context->event.type == SDL_KEYDOWN);
+		SDL_FlushEvent(rinput_context->event.type == SDL_KEYUP);
+		_FlushKeyState();
 	}
 
 	//-----------------------------------------------------------------------------
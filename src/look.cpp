@@ -0,0 +1,208 @@
+/*
+MIT License
+
+Copyright (c) 2019 Reep Softworks
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#include <vector>
+#include <string>
+#include <math.h>
+#include "rinput.h"
+#include "context.h"
+
+// Mouse counts are normalized to this DPI before sensitivity is applied.
+#define LOOK_REFERENCE_DPI 800.0f
+
+namespace RInput
+{
+	//-----------------------------------------------------------------------------
+	// Purpose: The default config for new looks.
+	//-----------------------------------------------------------------------------
+	lookconfig_t _DefaultLookConfig()
+	{
+		lookconfig_t c;
+		c.sensitivity = 1.0f;
+		c.acceleration = 0.0f;
+		c.dpi = LOOK_REFERENCE_DPI;
+		c.stickspeed = 1000.0f;
+		c.stickcurve = 2.0f;
+		c.port = RInput_GamePad::ENUM_GAMEPAD_ONE;
+		c.bInvertY = false;
+		return c;
+	}
+
+	void _PrecomputeLook(look_t& l)
+	{
+		float dpi = l.config.dpi > 0.0f ? l.config.dpi : LOOK_REFERENCE_DPI;
+		float norm = LOOK_REFERENCE_DPI / dpi;
+		l.fMouseScale = l.config.sensitivity * norm;
+		l.fMouseAccel = l.config.acceleration * norm;
+		l.fInvert = l.config.bInvertY ? -1.0f : 1.0f;
+	}
+
+	//-----------------------------------------------------------------------------
+	// Purpose: Register a look driven by the mouse, or pStick
+	// (GAMEPAD_AXIS_LSTICK/RSTICK) on port pWhich when the gamepad is active.
+	//-----------------------------------------------------------------------------
+	int RegisterLook(const std::string& pLookName, const Sint8& pStick, const Sint32& pWhich)
+	{
+		int i = GetLookIndex(pLookName);
+		if (i < 0)
+		{
+			look_t l;
+			l.name = pLookName;
+			l.config = _DefaultLookConfig();
+			l.x = l.y = 0.0f;
+			l.iX = l.iY = 0;
+			l.fRemainderX = l.fRemainderY = 0.0f;
+			rinput_context->vLooks.push_back(l);
+			i = (int)rinput_context->vLooks.size() - 1;
+		}
+
+		rinput_context->vLooks[i].stick = pStick;
+		rinput_context->vLooks[i].config.port = pWhich;
+		_PrecomputeLook(rinput_context->vLooks[i]);
+		return i;
+	}
+
+	//-----------------------------------------------------------------------------
+	// Purpose: Change a look's config, registering it on the right stick if
+	// it doesn't exist yet.
+	//-----------------------------------------------------------------------------
+	void ModifyLook(const std::string& pLookName, const lookconfig_t& pConfig)
+	{
+		int i = GetLookIndex(pLookName);
+		if (i < 0) i = RegisterLook(pLookName, GAMEPAD_AXIS_RSTICK);
+
+		rinput_context->vLooks[i].config = pConfig;
+		_PrecomputeLook(rinput_context->vLooks[i]);
+	}
+
+	int GetLookIndex(const std::string& pLookName)
+	{
+		for (size_t i = 0; i < rinput_context->vLooks.size(); i++)
+		{
+			if (rinput_context->vLooks[i].name == pLookName) return (int)i;
+		}
+
+		return -1;
+	}
+
+	lookconfig_t GetLookConfig(const std::string& pLookName)
+	{
+		int i = GetLookIndex(pLookName);
+		return (i >= 0) ? rinput_context->vLooks[i].config : _DefaultLookConfig();
+	}
+
+	int GetLookCount()
+	{
+		return (int)rinput_context->vLooks.size();
+	}
+
+	const char* GetLookName(const int iLook)
+	{
+		if (iLook < 0 || iLook >= (int)rinput_context->vLooks.size()) return "";
+		return rinput_context->vLooks[iLook].name.c_str();
+	}
+
+	//-----------------------------------------------------------------------------
+	// Purpose: This frame's look movement.
+	//-----------------------------------------------------------------------------
+	void GetLook(const int iLook, float& x, float& y)
+	{
+		if (iLook < 0 || iLook >= (int)rinput_context->vLooks.size())
+		{
+			x = y = 0.0f;
+			return;
+		}
+
+		x = rinput_context->vLooks[iLook].x;
+		y = rinput_context->vLooks[iLook].y;
+	}
+
+	//-----------------------------------------------------------------------------
+	// Purpose: This frame's look movement in whole units. The fraction is
+	// carried into the next frame so slow movement isn't lost.
+	//-----------------------------------------------------------------------------
+	void GetLookPixels(const int iLook, int& x, int& y)
+	{
+		if (iLook < 0 || iLook >= (int)rinput_context->vLooks.size())
+		{
+			x = y = 0;
+			return;
+		}
+
+		x = rinput_context->vLooks[iLook].iX;
+		y = rinput_context->vLooks[iLook].iY;
+	}
+
+	//-----------------------------------------------------------------------------
+	// Purpose: Work out every look's movement for the frame. Called by Update.
+	//-----------------------------------------------------------------------------
+	void UpdateLooks()
+	{
+		Uint64 now = SDL_GetPerformanceCounter();
+		float dt = 0.0f;
+		if (rinput_context->look_last_counter != 0)
+		{
+			dt = (float)((double)(now - rinput_context->look_last_counter) / (double)SDL_GetPerformanceFrequency());
+			if (dt > 0.25f) dt = 0.25f; // Don't jump after a hitch.
+		}
+		rinput_context->look_last_counter = now;
+
+		if (rinput_context->vLooks.empty()) return;
+
+		bool bGamePad = GetActiveDevice() == CONTROLLER_GAMEPAD;
+
+		int mx, my;
+		RInput_KM::GetMouseDelta(mx, my);
+		float fMouseSpeed = 0.0f;
+		if (!bGamePad && dt > 0.0f)
+		{
+			// Counts per millisecond.
+			fMouseSpeed = sqrtf((float)(mx * mx + my * my)) / (dt * 1000.0f);
+		}
+
+		for (std::vector<look_t>::iterator l = rinput_context->vLooks.begin(); l != rinput_context->vLooks.end(); ++l)
+		{
+			if (bGamePad)
+			{
+				float sx, sy;
+				RInput_GamePad::GetStickCurved(l->config.port, l->stick, l->config.stickcurve, sx, sy);
+				l->x = sx * l->config.stickspeed * dt;
+				l->y = sy * l->config.stickspeed * dt * l->fInvert;
+			}
+			else
+			{
+				float gain = l->fMouseScale * (1.0f + l->fMouseAccel * fMouseSpeed);
+				l->x = (float)mx * gain;
+				l->y = (float)my * gain * l->fInvert;
+			}
+
+			l->fRemainderX += l->x;
+			l->fRemainderY += l->y;
+			l->iX = (int)l->fRemainderX;
+			l->iY = (int)l->fRemainderY;
+			l->fRemainderX -= (float)l->iX;
+			l->fRemainderY -= (float)l->iY;
+		}
+	}
+}
@@ -0,0 +1,170 @@
+/*
+MIT License
+
+Copyright (c) 2019 Reep Softworks
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#include <vector>
+#include <string>
+#include <string.h>
+#include "rinput.h"
+#include "context.h"
+
+namespace RInput
+{
+	inputqueue_t::inputqueue_t()
+	{
+		tail = 0;
+		iQueued = 0;
+		iDropped = 0;
+		head = 0;
+		iHighWater = 0;
+		iStaged = 0;
+		for (size_t i = 0; i < RINPUT_INPUT_QUEUE_SIZE; i++)
+		{
+			cells[i].seq.store(i, std::memory_order_relaxed);
+		}
+	}
+
+	//-----------------------------------------------------------------------------
+	// Purpose: Queue a record for the main thread. Timestamps of 0 are taken
+	// now, so the drain order is the order inputs arrived in.
+	//-----------------------------------------------------------------------------
+	bool QueueInput(const inputrecord_t& pRecord, const Sint32 iPort)
+	{
+		inputqueue_t& q = rinput_context->input_queue;
+
+		size_t pos = q.tail.load(std::memory_order_relaxed);
+		queuecell_t* cell;
+		for (;;)
+		{
+			cell = &q.cells[pos & (RINPUT_INPUT_QUEUE_SIZE - 1)];
+			size_t seq = cell->seq.load(std::memory_order_acquire);
+			intptr_t diff = (intptr_t)seq - (intptr_t)pos;
+
+			if (diff == 0)
+			{
+				if (q.tail.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) break;
+			}
+			else if (diff < 0)
+			{
+				q.iDropped.fetch_add(1, std::memory_order_relaxed);
+				return false;
+			}
+			else
+			{
+				pos = q.tail.load(std::memory_order_relaxed);
+			}
+		}
+
+		cell->record = pRecord;
+		if (cell->record.timestamp == 0)
+		{
+			cell->record.timestamp = SDL_GetTicks();
+			if (cell->record.timestamp == 0) cell->record.timestamp = 1;
+		}
+		cell->port = iPort;
+		cell->seq.store(pos + 1, std::memory_order_release);
+
+		q.iQueued.fetch_add(1, std::memory_order_relaxed);
+		return true;
+	}
+
+	//-----------------------------------------------------------------------------
+	// Purpose: Apply queued records up to iUntil, oldest first. Later ones
+	// stay staged, so TestEvents can slot them between device events.
+	//-----------------------------------------------------------------------------
+	void _DrainInputQueue(const Uint32 iUntil)
+	{
+		inputqueue_t& q = rinput_context->input_queue;
+
+		for (;;)
+		{
+			queuecell_t& cell = q.cells[q.head & (RINPUT_INPUT_QUEUE_SIZE - 1)];
+			if (cell.seq.load(std::memory_order_acquire) != q.head + 1) break;
+
+			if (q.iStaged < RINPUT_INPUT_QUEUE_SIZE)
+			{
+				// Producers race each other for cells, so only the timestamps
+				// give the real order. They arrive nearly sorted, so insert
+				// from the back; equal ones keep their queue order.
+				Uint32 i = q.iStaged++;
+				for (; i > 0 && q.staged[i - 1].timestamp > cell.record.timestamp; i--)
+				{
+					q.staged[i] = q.staged[i - 1];
+					q.stagedPort[i] = q.stagedPort[i - 1];
+				}
+				q.staged[i] = cell.record;
+				q.stagedPort[i] = cell.port;
+			}
+			else
+			{
+				// Only records stamped ahead of the events can pile up here.
+				q.iDropped.fetch_add(1, std::memory_order_relaxed);
+			}
+
+			cell.seq.store(q.head + RINPUT_INPUT_QUEUE_SIZE, std::memory_order_release);
+			q.head++;
+		}
+
+		if (q.iStaged == 0) return;
+		if (q.iStaged > q.iHighWater) q.iHighWater = q.iStaged;
+
+		Uint32 iEnd = 0;
+		while (iEnd < q.iStaged && q.staged[iEnd].timestamp <= iUntil) iEnd++;
+
+		// One InjectInputs call per run of records for the same port.
+		for (Uint32 i = 0; i < iEnd;)
+		{
+			Uint32 j = i + 1;
+			while (j < iEnd && q.stagedPort[j] == q.stagedPort[i]) j++;
+
+			// Records that can't apply (bad code or port) count as dropped.
+			size_t applied = InjectInputs(&q.staged[i], j - i, q.stagedPort[i]);
+			if (applied < j - i) q.iDropped.fetch_add((Uint32)(j - i - applied), std::memory_order_relaxed);
+			i = j;
+		}
+
+		if (iEnd == 0) return;
+
+		q.iStaged -= iEnd;
+		memmove(q.staged, q.staged + iEnd, q.iStaged * sizeof(q.staged[0]));
+		memmove(q.stagedPort, q.stagedPort + iEnd, q.iStaged * sizeof(q.stagedPort[0]));
+	}
+
+	//-----------------------------------------------------------------------------
+	// Purpose: Apply everything queued so far. Records queued while this
+	// runs wait for the next frame.
+	//-----------------------------------------------------------------------------
+	void DrainInputQueue()
+	{
+		_DrainInputQueue(0xFFFFFFFF);
+	}
+
+	inputqueuestats_t GetInputQueueStats()
+	{
+		inputqueuestats_t s;
+		s.iQueued = rinput_context->input_queue.iQueued.load(std::memory_order_relaxed);
+		s.iDropped = rinput_context->input_queue.iDropped.load(std::memory_order_relaxed);
+		s.iHighWater = rinput_context->input_queue.iHighWater;
+		return s;
+	}
+}
@@ -25,16 +25,66 @@ SOFTWARE.
 #include <vector>
 #include <map>
 #include <string>
+#include <atomic>
 #include "rinput.h"
+#include "context.h"
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#include <windows.h>
+#endif
 
 #include "tinyxml2.h"
 using namespace tinyxml2;
 
-SDL_Window* actioncontroller_window;
-SDL_Event actioncontroller_event;
-
 namespace RInput
 {
+	//-----------------------------------------------------------------------------
+	// Purpose: The default context the free functions use until another one
+	// is made current. Each thread starts out on it.
+	//-----------------------------------------------------------------------------
+	Context default_context;
+	thread_local Context* rinput_context = &default_context;
+
+	//-----------------------------------------------------------------------------
+	// Purpose: An independent input stack, e.g. for an editor viewport next
+	// to a play session, or for tests running in parallel.
+	//-----------------------------------------------------------------------------
+	Context* CreateContext()
+	{
+		return new Context(); // <- Value-initialized, so it starts zeroed like the default.
+	}
+
+	//-----------------------------------------------------------------------------
+	// Purpose: Free a context. Only the calling thread's pointer can be
+	// reset here; other threads must have switched away already.
+	//-----------------------------------------------------------------------------
+	void DestroyContext(Context* pContext)
+	{
+		if (pContext == NULL || pContext == &default_context) return;
+		if (rinput_context == pContext) rinput_context = &default_context;
+		delete pContext;
+	}
+
+	//-----------------------------------------------------------------------------
+	// Purpose: Point the calling thread's API calls at a context. NULL goes
+	// back to the default one.
+	//-----------------------------------------------------------------------------
+	void SetCurrentContext(Context* pContext)
+	{
+		rinput_context = (pContext != NULL) ? pContext : &default_context;
+	}
+
+	Context* GetCurrentContext()
+	{
+		return rinput_context;
+	}
+
+	SDL_Window* GetWindow()
+	{
+		return rinput_context->window;
+	}
+
 	//-----------------------------------------------------------------------------
 	// Purpose: Shared Init function.
 	//-----------------------------------------------------------------------------
@@ -51,11 +101,24 @@ namespace RInput
 		SDL_SetHint(SDL_HINT_GAMECONTROLLERCONFIG, "1");
 		if (SDL_InitSubSystem(SDL_INIT_GAMECONTROLLER) >= 0)
 		{
+			// Also define RINPUT_LAZY_GAMECONTROLLERCONFIG to only add mappings
+			// for unknown devices as they're plugged in, or build with
+			// RINPUT_EMBED_GAMECONTROLLERDB to use the table compiled into
+			// the library instead of the text file.
+	#if defined(RINPUT_EMBEDDED_GAMECONTROLLERDB)
+			// Nothing to load; devices are looked up as they're added.
+	#elif defined(RINPUT_LAZY_GAMECONTROLLERCONFIG)
+			if (!RInput_GamePad::OpenMappingDatabase("gamecontrollerdb.txt"))
+			{
+				printf("Failed to open controller database!\n");
+			}
+	#else
 			int iNumOfControllers = SDL_GameControllerAddMappingsFromFile("gamecontrollerdb.txt");
 			if (iNumOfControllers == -1)
 			{
 				printf("Failed to load controller database! SDL Error: %s\n", SDL_GetError());
 			}
+	#endif
 		}
 		else
 		{
@@ -72,9 +135,9 @@ namespace RInput
 	//-----------------------------------------------------------------------------
 	void Init(SDL_Window* pWindow)
 	{
-		if (actioncontroller_window == NULL)
+		if (rinput_context->window == NULL)
 		{
-			actioncontroller_window = pWindow;
+			rinput_context->window = pWindow;
 		}
 	
 		_Init();
@@ -87,7 +150,7 @@ namespace RInput
 	{
 		if (SDL_Init(SDL_INIT_VIDEO | SDL_INIT_TIMER) >= 0)
 		{
-			actioncontroller_window = SDL_CreateWindowFrom(data);
+			rinput_context->window = SDL_CreateWindowFrom(data);
 			_Init();
 		}
 		else
@@ -99,10 +162,9 @@ namespace RInput
 	//-----------------------------------------------------------------------------
 	// Purpose: Sets the device mode based on what was last 'waken'.
 	//-----------------------------------------------------------------------------
-	Controllers_t acitve_device;
 	void SetActiveDevice(const Controllers_t& pDevice)
 	{
-		if (acitve_device != pDevice)
+		if (rinput_context->active_device != pDevice)
 		{
 			std::string s;
 			if (pDevice > CONTROLLER_KEYBOARDMOUSE) s = "Gamepad";
@@ -113,7 +175,7 @@ namespace RInput
 			}
 				
 			printf("%s is now the current device.\n", s.c_str());
-			acitve_device = pDevice;
+			rinput_context->active_device = pDevice;
 		}
 	}
 
@@ -122,7 +184,7 @@ namespace RInput
 	//-----------------------------------------------------------------------------
 	Controllers_t GetActiveDevice()
 	{
-		return acitve_device;
+		return rinput_context->active_device;
 	}
 
 	//-----------------------------------------------------------------------------
@@ -130,8 +192,8 @@ namespace RInput
 	//-----------------------------------------------------------------------------
 	const char* GetActiveDeviceAsString()
 	{
-		if (acitve_device == CONTROLLER_GAMEPAD) return "GamePad";
-		if (acitve_device == CONTROLLER_KEYBOARDMOUSE) return "KeyboardMouse";
+		if (rinput_context->active_device == CONTROLLER_GAMEPAD) return "GamePad";
+		if (rinput_context->active_device == CONTROLLER_KEYBOARDMOUSE) return "KeyboardMouse";
 		return "unknown";
 	}
 
@@ -147,34 +209,12 @@ namespace RInput
 		return "unknown";
 	}
 
-	//-----------------------------------------------------------------------------
-	// Purpose: Private Functions to capture mouse events as button events. 
-	//-----------------------------------------------------------------------------
-	void FixMouseBtnDown(const Uint8& pButton)
-	{
-		long b = pButton;
-		if (b == SDL_BUTTON_LEFT) b = MOUSE_BUTTON_LEFT;
-		if (b == SDL_BUTTON_MIDDLE) b = MOUSE_BUTTON_MIDDLE;
-		if (b == SDL_BUTTON_RIGHT) b = MOUSE_BUTTON_RIGHT;
-		RInput_KM::SimulateButton(b, true);
-	}
-
-	void FixMouseBtnUp(const Uint8& pButton)
-	{
-		long b = pButton;
-		if (b == SDL_BUTTON_LEFT) b = MOUSE_BUTTON_LEFT;
-		if (b == SDL_BUTTON_MIDDLE) b = MOUSE_BUTTON_MIDDLE;
-		if (b == SDL_BUTTON_RIGHT) b = MOUSE_BUTTON_RIGHT;
-		RInput_KM::SimulateButton(b, false);
-	}
-
 	//-----------------------------------------------------------------------------
 	// Purpose: Returns the amount of gamepads connected.
 	//-----------------------------------------------------------------------------
-	Sint8 gamepad_count = 0;
 	Sint8 GetGamePadCount()
 	{
-		return gamepad_count;
+		return rinput_context->gamepad_count;
 	}
 
 	//-----------------------------------------------------------------------------
@@ -182,74 +222,108 @@ namespace RInput
 	//-----------------------------------------------------------------------------
 	void TestEvents(const SDL_Event& pEvent)
 	{
-		if (actioncontroller_event.type != pEvent.type) actioncontroller_event = pEvent;
+		if (rinput_context->event.type != pEvent.type) rinput_context->event = pEvent;
+
+		_CountEvent(pEvent.type);
+		_DrainInputQueue(pEvent.common.timestamp);
+		ComboTestEvent(pEvent);
+		bool bEdge = false;
 
 		switch (pEvent.type)
 		{
 		// Game Pad:
+#if defined(USE_RINPUT_GAMECONTROLLERCONFIG) && (defined(RINPUT_LAZY_GAMECONTROLLERCONFIG) || defined(RINPUT_EMBEDDED_GAMECONTROLLERDB))
+		// Joysticks SDL can't map never get a controller event, so look them
+		// up here. SDL follows up with SDL_CONTROLLERDEVICEADDED on success.
+		case SDL_JOYDEVICEADDED:
+			RInput_GamePad::AddMappingForDevice(pEvent.jdevice.which);
+			break;
+#endif
+
 		case SDL_CONTROLLERDEVICEADDED:
 			RInput_GamePad::Connect(pEvent.cdevice.which);
-			gamepad_count++;
+			rinput_context->gamepad_count++;
 			SetActiveDevice(CONTROLLER_GAMEPAD);
 			break;
 
 		case SDL_CONTROLLERDEVICEREMOVED:
 			RInput_GamePad::Disconnect(pEvent.cdevice.which);
-			gamepad_count--;
+			rinput_context->gamepad_count--;
 			SetActiveDevice(CONTROLLER_KEYBOARDMOUSE);
 			break;
 
 		case SDL_CONTROLLERBUTTONDOWN:
-			RInput_GamePad::SimulateButton(pEvent.cdevice.which, pEvent.cbutton.button, true);
+			RInput_GamePad::SimulateButton(pEvent.cdevice.which, pEvent.cbutton.button, true, pEvent.cbutton.timestamp);
 			SetActiveDevice(CONTROLLER_GAMEPAD);
+			bEdge = true;
 			break;
 
 		case SDL_CONTROLLERBUTTONUP:
-			RInput_GamePad::SimulateButton(pEvent.cdevice.which, pEvent.cbutton.button, false);
+			RInput_GamePad::SimulateButton(pEvent.cdevice.which, pEvent.cbutton.button, false, pEvent.cbutton.timestamp);
 			SetActiveDevice(CONTROLLER_GAMEPAD);
+			bEdge = true;
 			break;
 
 		case SDL_CONTROLLERAXISMOTION:
-			//RInput_GamePad::UpdateAxisMotions(pEvent.cdevice.which, pEvent.caxis.axis);
+			RInput_GamePad::UpdateAxisMotions(pEvent.caxis.which, pEvent.caxis.axis, pEvent.caxis.value, pEvent.caxis.timestamp);
 			SetActiveDevice(CONTROLLER_GAMEPAD);
+			bEdge = true;
 			break;
 
 		// Keyboard + Mouse:
 		case SDL_KEYDOWN:
-			RInput_KM::SimulateButton(pEvent.key.keysym.sym, true);
+			RInput_KM::SimulateButton(pEvent.key.keysym.sym, true, pEvent.key.timestamp);
 			SetActiveDevice(CONTROLLER_KEYBOARDMOUSE);
+			bEdge = true;
 			break;
 
 		case SDL_KEYUP:
-			RInput_KM::SimulateButton(pEvent.key.keysym.sym, false);
+			RInput_KM::SimulateButton(pEvent.key.keysym.sym, false, pEvent.key.timestamp);
 			SetActiveDevice(CONTROLLER_KEYBOARDMOUSE);
+			bEdge = true;
 			break;
 
 		case SDL_MOUSEBUTTONDOWN:
-			FixMouseBtnDown(pEvent.button.button);
+			RInput_KM::SimulateMouseButton(pEvent.button.button, true, pEvent.button.timestamp);
 			SetActiveDevice(CONTROLLER_KEYBOARDMOUSE);
+			bEdge = true;
 			break;
 
 		case SDL_MOUSEBUTTONUP:
-			FixMouseBtnUp(pEvent.button.button);
+			RInput_KM::SimulateMouseButton(pEvent.button.button, false, pEvent.button.timestamp);
 			SetActiveDevice(CONTROLLER_KEYBOARDMOUSE);
+			bEdge = true;
 			break;
 
 		case SDL_MOUSEWHEEL:
-			RInput_KM::SetMouseWheelPosition(pEvent.wheel.y);
+		{
+#if SDL_VERSION_ATLEAST(2, 0, 18)
+			float fPrecise = pEvent.wheel.preciseY;
+#else
+			float fPrecise = (float)pEvent.wheel.y;
+#endif
+			RInput_KM::AddMouseWheel(pEvent.wheel.y, fPrecise);
 			break;
+		}
 
 		case SDL_MOUSEMOTION:
-			RInput_KM::UpdateMousePosition();
+			// The event already carries the position; no need to ask SDL.
+			RInput_KM::SimulateMouse(pEvent.motion.x, pEvent.motion.y);
+			RInput_KM::AddMouseMotion(pEvent.motion.xrel, pEvent.motion.yrel);
 			break;
 
 		default:
 			break;
 		}
 
+		// Step interactions on each edge, so several presses in a frame count.
+		if (bEdge) _InteractionEdge((Uint8)GetActiveDevice(), pEvent.common.timestamp);
+
 		if (GetActiveDevice() == CONTROLLER_GAMEPAD)
 		{
 			SDL_GameControllerUpdate();
+			RINPUT_COUNT(iControllerUpdates);
+			RINPUT_COUNT(iSDLCalls);
 		}
 	}
 
@@ -258,10 +332,38 @@ namespace RInput
 	//-----------------------------------------------------------------------------
 	void PollEvents()
 	{
-		while (SDL_PollEvent(&actioncontroller_event) != 0)
+		Uint64 start = SDL_GetPerformanceCounter();
+
+		RINPUT_COUNT(iSDLCalls);
+		while (SDL_PollEvent(&rinput_context->event) != 0)
 		{
-			TestEvents(actioncontroller_event);
+			TestEvents(rinput_context->event);
+			RINPUT_COUNT(iSDLCalls);
 		}
+
+		rinput_context->counters_poll_ticks += SDL_GetPerformanceCounter() - start;
+		Update();
+	}
+
+	//-----------------------------------------------------------------------------
+	// Purpose: Per-frame work. Call once a frame after passing the frame's
+	// events to TestEvents (PollEvents does this for you).
+	//-----------------------------------------------------------------------------
+	void Update()
+	{
+		rinput_context->counters_update_start = SDL_GetPerformanceCounter();
+
+		DrainInputQueue();
+		RInput_KM::UpdateMouseDelta();
+		RInput_KM::UpdateMouseWheel();
+		UpdateInteractions();
+		UpdateLooks();
+		UpdateGamePadCursor();
+		PublishSnapshot();
+#ifndef RINPUT_NO_RUMBLE
+		UpdateRumble();
+#endif
+		_FinishFrameCounters();
 	}
 
 	//-----------------------------------------------------------------------------
@@ -296,24 +398,113 @@ namespace RInput
 	}
 
 	//====================================================================
-	std::map<std::string, action_t> mActions;
+	//-----------------------------------------------------------------------------
+	// Purpose: Value of a chord; the weakest held input, or 0 if one is up.
+	//-----------------------------------------------------------------------------
+	float _BindingInput(const binding_t& pBinding)
+	{
+		float t = 1.0f;
+		for (Uint8 i = 0; i < pBinding.count; i++)
+		{
+			float v;
+			if (pBinding.device == CONTROLLER_KEYBOARDMOUSE)
+			{
+				v = RInput_KM::ButtonDown(pBinding.inputs[i]);
+			}
+			else
+			{
+				v = RInput_GamePad::ButtonDown((Uint8)pBinding.inputs[i]);
+			}
+
+			if (v < t) t = v;
+			if (t <= 0.0f) return 0.0f;
+		}
+
+		return t;
+	}
 
 	//-----------------------------------------------------------------------------
-	// Purpose: Test the action state.
+	// Purpose: The action's current value, without the hit-once latch.
 	//-----------------------------------------------------------------------------
-	float GetActionInput(action_t& pButton)
+	float _ActionValue(const action_t& pButton)
+	{
+		return _ActionValueOn(pButton, (Uint8)GetActiveDevice());
+	}
+
+	float _ActionValueOn(const action_t& pButton, const Uint8 device)
 	{
 		float t = 0.0f;
 
-		if (GetActiveDevice() == CONTROLLER_KEYBOARDMOUSE)
+		if (device == CONTROLLER_KEYBOARDMOUSE)
 		{
 			t = RInput_KM::ButtonDown(pButton.key);
 		}
-		else if (GetActiveDevice() == CONTROLLER_GAMEPAD)
+		else if (device == CONTROLLER_GAMEPAD)
 		{
 			t = RInput_GamePad::ButtonDown(pButton.button);
 		}
 
+		for (Uint8 i = 0; i < pButton.iBindingCount; i++)
+		{
+			if (pButton.bindings[i].device != device) continue;
+
+			float v = _BindingInput(pButton.bindings[i]);
+			if (v > t) t = v;
+		}
+
+		return t;
+	}
+
+	//-----------------------------------------------------------------------------
+	// Purpose: GetActionValue in Q1.15. Keys are 0 or RINPUT_FIXED_ONE, and
+	// analog inputs come from the raw axis through integer math only.
+	//-----------------------------------------------------------------------------
+	Sint16 _InputFixed(const Uint8& pDevice, const Sint32& pInput)
+	{
+		if (pDevice == CONTROLLER_KEYBOARDMOUSE) return RInput_KM::ButtonDown(pInput) > 0.0f ? RINPUT_FIXED_ONE : 0;
+		return RInput_GamePad::ButtonDownFixed((Uint8)pInput);
+	}
+
+	Sint16 _ActionValueFixed(const action_t& pButton)
+	{
+		Sint16 t = 0;
+		Controllers_t device = GetActiveDevice();
+
+		if (device == CONTROLLER_KEYBOARDMOUSE)
+		{
+			t = _InputFixed((Uint8)device, pButton.key);
+		}
+		else if (device == CONTROLLER_GAMEPAD)
+		{
+			t = _InputFixed((Uint8)device, (Sint32)pButton.button);
+		}
+
+		for (Uint8 i = 0; i < pButton.iBindingCount; i++)
+		{
+			const binding_t& b = pButton.bindings[i];
+			if (b.device != device) continue;
+
+			Sint16 v = RINPUT_FIXED_ONE;
+			for (Uint8 j = 0; j < b.count && v > 0; j++)
+			{
+				Sint16 c = _InputFixed(b.device, b.inputs[j]);
+				if (c < v) v = c;
+			}
+
+			if (v > t) t = v;
+		}
+
+		return t;
+	}
+
+	//-----------------------------------------------------------------------------
+	// Purpose: Test the action state.
+	//-----------------------------------------------------------------------------
+	float GetActionInput(action_t& pButton)
+	{
+		RINPUT_COUNT(iActionQueries);
+		float t = _ActionValue(pButton);
+
 		// Button is not returning 0.
 		if (t > 0.0f)
 		{
@@ -343,14 +534,30 @@ namespace RInput
 		return t;
 	}
 
+	//-----------------------------------------------------------------------------
+	// Purpose: Find an action, creating it (and giving it a snapshot slot)
+	// the first time it's named.
+	//-----------------------------------------------------------------------------
+	action_t& _Action(const std::string& pActionName)
+	{
+		std::map<std::string, action_t>::iterator it = rinput_context->mActions.find(pActionName);
+		if (it != rinput_context->mActions.end()) return it->second;
+
+		action_t& a = rinput_context->mActions[pActionName];
+		a.iSlot = (Uint16)rinput_context->vActionSlots.size();
+		rinput_context->vActionSlots.push_back(&a);
+		return a;
+	}
+
 	//-----------------------------------------------------------------------------
 	// Purpose: Register the action.
 	//-----------------------------------------------------------------------------
 	void RegisterAction(const std::string& pActionName, Sint32 iKey, Uint8 iButton, bool bConistant)
 	{
-		mActions[pActionName].key = iKey;
-		mActions[pActionName].button = iButton;
-		mActions[pActionName].bHit = !bConistant;
+		action_t& a = _Action(pActionName);
+		a.key = iKey;
+		a.button = iButton;
+		a.bHit = !bConistant;
 	}
 
 	//-----------------------------------------------------------------------------
@@ -359,8 +566,42 @@ namespace RInput
 	void ModifyAction(const std::string& pActionName, Sint32 iKey, Uint8 iButton)
 	{
 		printf("Setting action '%s' Key: '%s' Button '%s'\n", pActionName.c_str(), RInput_KM::GetButtonName(iKey), RInput_GamePad::GetButtonName(iButton));
-		mActions[pActionName].key = iKey;
-		mActions[pActionName].button = iButton;
+		action_t& a = _Action(pActionName);
+		a.key = iKey;
+		a.button = iButton;
+	}
+
+	//-----------------------------------------------------------------------------
+	// Purpose: Give the action another binding. pInputs holds keys for
+	// CONTROLLER_KEYBOARDMOUSE or buttons for CONTROLLER_GAMEPAD; more than one
+	// makes a chord. Returns false if the action or chord is full.
+	//-----------------------------------------------------------------------------
+	bool AddActionBinding(const std::string& pActionName, const Controllers_t& pDevice, const Sint32* pInputs, Uint8 iCount)
+	{
+		action_t& action = _Action(pActionName);
+		if (action.iBindingCount >= RINPUT_MAX_BINDINGS || iCount == 0 || iCount > RINPUT_MAX_CHORD)
+		{
+			printf("Failed to add binding to action '%s'.\n", pActionName.c_str());
+			return false;
+		}
+
+		binding_t& b = action.bindings[action.iBindingCount++];
+		b.device = (Uint8)pDevice;
+		b.count = iCount;
+		for (Uint8 i = 0; i < iCount; i++)
+		{
+			b.inputs[i] = pInputs[i];
+		}
+
+		return true;
+	}
+
+	//-----------------------------------------------------------------------------
+	// Purpose: Remove every binding added with AddActionBinding.
+	//-----------------------------------------------------------------------------
+	void ClearActionBindings(const std::string& pActionName)
+	{
+		_Action(pActionName).iBindingCount = 0;
 	}
 
 	//-----------------------------------------------------------------------------
@@ -368,13 +609,247 @@ namespace RInput
 	//-----------------------------------------------------------------------------
 	action_t& GetAction(const std::string& pActionName)
 	{
-		return mActions[pActionName];
+		return _Action(pActionName);
+	}
+
+	int GetActionSlot(const std::string& pActionName)
+	{
+		return _Action(pActionName).iSlot;
+	}
+
+	//-----------------------------------------------------------------------------
+	// Purpose: When an input last went down, and whether it's been let go
+	// since the given time.
+	//-----------------------------------------------------------------------------
+	Uint32 _InputPressTime(const Uint8& pDevice, const Sint32& pInput)
+	{
+		if (pDevice == CONTROLLER_KEYBOARDMOUSE) return RInput_KM::ButtonPressTime(pInput);
+		return RInput_GamePad::ButtonPressTime((Uint8)pInput);
+	}
+
+	Uint32 _InputReleaseTime(const Uint8& pDevice, const Sint32& pInput)
+	{
+		if (pDevice == CONTROLLER_KEYBOARDMOUSE) return RInput_KM::ButtonReleaseTime(pInput);
+		return RInput_GamePad::ButtonReleaseTime((Uint8)pInput);
+	}
+
+	bool _InputHeldAt(const Uint8& pDevice, const Sint32& pInput, const Uint32& t)
+	{
+		Uint32 down = _InputPressTime(pDevice, pInput);
+		Uint32 up = _InputReleaseTime(pDevice, pInput);
+		return down != 0 && down <= t && (up < down || up >= t);
+	}
+
+	//-----------------------------------------------------------------------------
+	// Purpose: A chord is pressed when its last input goes down while the
+	// others are held.
+	//-----------------------------------------------------------------------------
+	Uint32 _BindingPressTime(const binding_t& pBinding)
+	{
+		Uint32 t = 0;
+		for (Uint8 i = 0; i < pBinding.count; i++)
+		{
+			Uint32 down = _InputPressTime(pBinding.device, pBinding.inputs[i]);
+			if (down == 0) return 0;
+			if (down > t) t = down;
+		}
+
+		for (Uint8 i = 0; i < pBinding.count; i++)
+		{
+			if (!_InputHeldAt(pBinding.device, pBinding.inputs[i], t)) return 0;
+		}
+
+		return t;
+	}
+
+	//-----------------------------------------------------------------------------
+	// Purpose: A chord is let go when the first of its inputs is.
+	//-----------------------------------------------------------------------------
+	Uint32 _BindingReleaseTime(const binding_t& pBinding)
+	{
+		Uint32 down = _BindingPressTime(pBinding);
+		if (down == 0) return 0;
+
+		Uint32 t = 0;
+		for (Uint8 i = 0; i < pBinding.count; i++)
+		{
+			Uint32 up = _InputReleaseTime(pBinding.device, pBinding.inputs[i]);
+			if (up >= down && (t == 0 || up < t)) t = up;
+		}
+
+		return t;
+	}
+
+	//-----------------------------------------------------------------------------
+	// Purpose: Latest press of any of the action's bindings on the active
+	// device.
+	//-----------------------------------------------------------------------------
+	Uint32 _ActionPressTime(const action_t& pAction)
+	{
+		Controllers_t device = GetActiveDevice();
+		Uint32 t = _InputPressTime((Uint8)device, device == CONTROLLER_KEYBOARDMOUSE ? pAction.key : (Sint32)pAction.button);
+
+		for (Uint8 i = 0; i < pAction.iBindingCount; i++)
+		{
+			if (pAction.bindings[i].device != device) continue;
+
+			Uint32 b = _BindingPressTime(pAction.bindings[i]);
+			if (b > t) t = b;
+		}
+
+		return t;
+	}
+
+	//-----------------------------------------------------------------------------
+	// Purpose: Latest release of any of the action's bindings on the active
+	// device. Only meaningful once the action reads as up.
+	//-----------------------------------------------------------------------------
+	Uint32 _ActionReleaseTime(const action_t& pAction)
+	{
+		Controllers_t device = GetActiveDevice();
+		Uint32 t = _InputReleaseTime((Uint8)device, device == CONTROLLER_KEYBOARDMOUSE ? pAction.key : (Sint32)pAction.button);
+
+		for (Uint8 i = 0; i < pAction.iBindingCount; i++)
+		{
+			if (pAction.bindings[i].device != device) continue;
+
+			Uint32 b = _BindingReleaseTime(pAction.bindings[i]);
+			if (b > t) t = b;
+		}
+
+		return t;
+	}
+
+	//-----------------------------------------------------------------------------
+	// Purpose: Was the action pressed in the last iMs milliseconds (and not
+	// consumed since)?
+	//-----------------------------------------------------------------------------
+	bool _PressedWithin(const action_t& pAction, const Uint32 iMs)
+	{
+		Uint32 t = _ActionPressTime(pAction);
+		if (t == 0 || t <= pAction.iConsumed) return false;
+
+		Uint32 now = SDL_GetTicks();
+		return now < t || now - t <= iMs;
+	}
+
+	bool WasPressedWithin(const action_t& pAction, const Uint32 iMs)
+	{
+		RINPUT_COUNT(iActionQueries);
+		return _PressedWithin(pAction, iMs);
+	}
+
+	//-----------------------------------------------------------------------------
+	// Purpose: Like WasPressedWithin, but a press is only reported once.
+	//-----------------------------------------------------------------------------
+	bool ConsumeBufferedPress(action_t& pAction, const Uint32 iMs)
+	{
+		RINPUT_COUNT(iActionQueries);
+		if (!_PressedWithin(pAction, iMs)) return false;
+
+		pAction.iConsumed = _ActionPressTime(pAction);
+		return true;
+	}
+
+	//-----------------------------------------------------------------------------
+	// Purpose: The public action reads. Only these count as queries; the
+	// library's own per-frame reads (snapshots, interactions, frames) use
+	// the helpers above directly.
+	//-----------------------------------------------------------------------------
+	float GetActionValue(const action_t& pButton)
+	{
+		RINPUT_COUNT(iActionQueries);
+		return _ActionValue(pButton);
+	}
+
+	Sint16 GetActionValueFixed(const action_t& pButton)
+	{
+		RINPUT_COUNT(iActionQueries);
+		return _ActionValueFixed(pButton);
+	}
+
+	Uint32 GetActionPressTime(const action_t& pAction)
+	{
+		RINPUT_COUNT(iActionQueries);
+		return _ActionPressTime(pAction);
+	}
+
+	Uint32 GetActionReleaseTime(const action_t& pAction)
+	{
+		RINPUT_COUNT(iActionQueries);
+		return _ActionReleaseTime(pAction);
+	}
+
+	//-----------------------------------------------------------------------------
+	// Purpose: An action's binding by name, as it appears in the XML file.
+	// Workers only ever deal in these; names are turned into key/button
+	// indices (and back) on the main thread, as the SDL keymap isn't
+	// thread safe.
+	//-----------------------------------------------------------------------------
+	typedef struct
+	{
+		std::string name;
+		std::string key;
+		std::string button;
+
+	} actionrecord_t;
+
+	// Which lookconfig_t fields a <Look> element set; the rest keep their
+	// current values.
+	#define LOOK_FIELD_SENSITIVITY	(1 << 0)
+	#define LOOK_FIELD_ACCELERATION	(1 << 1)
+	#define LOOK_FIELD_DPI			(1 << 2)
+	#define LOOK_FIELD_STICKSPEED	(1 << 3)
+	#define LOOK_FIELD_STICKCURVE	(1 << 4)
+	#define LOOK_FIELD_INVERT		(1 << 5)
+	#define LOOK_FIELD_PORT			(1 << 6)
+	#define LOOK_FIELD_ALL			0x7F
+
+	typedef struct
+	{
+		std::string name;
+		lookconfig_t config;
+		Uint8 iFields;
+
+	} lookrecord_t;
+
+	//-----------------------------------------------------------------------------
+	// Purpose: A <Haptic> element: either keyframes, or an envelope that is
+	// turned into keyframes when applied.
+	//-----------------------------------------------------------------------------
+	typedef struct
+	{
+		std::string name;
+		bool bLoop;
+		bool bEnvelope;
+		std::vector<haptickey_t> vKeys;
+		Uint16 left, right;
+		Uint32 attack, sustain, decay;
+
+	} hapticrecord_t;
+
+	//-----------------------------------------------------------------------------
+	// Purpose: Everything read from (or written to) a bindings file.
+	//-----------------------------------------------------------------------------
+	typedef struct
+	{
+		std::vector<actionrecord_t> vActions;
+		std::vector<lookrecord_t> vLooks;
+		std::vector<hapticrecord_t> vHaptics;
+
+	} actionfile_t;
+
+	Uint16 _HapticLevel(const XMLElement* pElement, const char* pszName)
+	{
+		unsigned v = 0;
+		pElement->QueryUnsignedAttribute(pszName, &v);
+		return (Uint16)(v > RUMBLE_MAX ? RUMBLE_MAX : v);
 	}
 
 	//-----------------------------------------------------------------------------
 	// Purpose: Uses tinyxml2 to phrase the config for action defs.
 	//-----------------------------------------------------------------------------
-	XMLError _ReadFile(const char* pszPath)
+	XMLError _ReadFile(const char* pszPath, actionfile_t& pFile)
 	{
 		XMLDocument xmlDoc;
 		XMLError eResult = xmlDoc.LoadFile(pszPath);
@@ -405,88 +880,426 @@ namespace RInput
 				if (pszValKey == nullptr) return XML_ERROR_PARSING_ATTRIBUTE;
 				const char* pszValButton = pActionElement->Attribute("button");
 				if (pszValButton == nullptr) return XML_ERROR_PARSING_ATTRIBUTE;
-				ModifyAction(pszValName, RInput_KM::GetButtonIndex(pszValKey), RInput_GamePad::GetButtonIndex(pszValButton));
+
+				actionrecord_t r;
+				r.name = pszValName;
+				r.key = pszValKey;
+				r.button = pszValButton;
+				pFile.vActions.push_back(r);
 
 				pActionElement = pActionElement->NextSiblingElement("Action");
 			}
 
-			pActionSetElement = pRoot->NextSiblingElement("ActionSet");
+			pActionSetElement = pActionSetElement->NextSiblingElement("ActionSet");
+		}
+
+		// Optional look settings, e.g.
+		// <Look name="Camera" sensitivity="1.5" acceleration="0.1" dpi="1600" stickspeed="900" stickcurve="2" port="0" invert="false"/>
+		XMLElement *pLookElement = pRoot->FirstChildElement("Look");
+		while (pLookElement != nullptr)
+		{
+			const char* pszValName = pLookElement->Attribute("name");
+			if (pszValName == nullptr) return XML_ERROR_PARSING_ATTRIBUTE;
+
+			lookrecord_t r;
+			r.name = pszValName;
+			r.iFields = 0;
+			if (pLookElement->QueryFloatAttribute("sensitivity", &r.config.sensitivity) == XML_SUCCESS) r.iFields |= LOOK_FIELD_SENSITIVITY;
+			if (pLookElement->QueryFloatAttribute("acceleration", &r.config.acceleration) == XML_SUCCESS) r.iFields |= LOOK_FIELD_ACCELERATION;
+			if (pLookElement->QueryFloatAttribute("dpi", &r.config.dpi) == XML_SUCCESS) r.iFields |= LOOK_FIELD_DPI;
+			if (pLookElement->QueryFloatAttribute("stickspeed", &r.config.stickspeed) == XML_SUCCESS) r.iFields |= LOOK_FIELD_STICKSPEED;
+			if (pLookElement->QueryFloatAttribute("stickcurve", &r.config.stickcurve) == XML_SUCCESS) r.iFields |= LOOK_FIELD_STICKCURVE;
+			if (pLookElement->QueryIntAttribute("port", &r.config.port) == XML_SUCCESS) r.iFields |= LOOK_FIELD_PORT;
+			if (pLookElement->QueryBoolAttribute("invert", &r.config.bInvertY) == XML_SUCCESS) r.iFields |= LOOK_FIELD_INVERT;
+			pFile.vLooks.push_back(r);
+
+			pLookElement = pLookElement->NextSiblingElement("Look");
+		}
+
+		// Optional haptic patterns, either keyframed:
+		// <Haptic name="Heartbeat" loop="true"><Key time="0" left="0" right="0"/>...</Haptic>
+		// or as an envelope:
+		// <Haptic name="Explosion" left="65535" right="40000" attack="20" sustain="150" decay="400"/>
+		XMLElement *pHapticElement = pRoot->FirstChildElement("Haptic");
+		while (pHapticElement != nullptr)
+		{
+			const char* pszValName = pHapticElement->Attribute("name");
+			if (pszValName == nullptr) return XML_ERROR_PARSING_ATTRIBUTE;
+
+			hapticrecord_t r;
+			r.name = pszValName;
+			r.bLoop = pHapticElement->BoolAttribute("loop");
+
+			XMLElement *pKeyElement = pHapticElement->FirstChildElement("Key");
+			r.bEnvelope = pKeyElement == nullptr;
+			r.left = _HapticLevel(pHapticElement, "left");
+			r.right = _HapticLevel(pHapticElement, "right");
+			r.attack = pHapticElement->UnsignedAttribute("attack");
+			r.sustain = pHapticElement->UnsignedAttribute("sustain");
+			r.decay = pHapticElement->UnsignedAttribute("decay");
+
+			while (pKeyElement != nullptr)
+			{
+				haptickey_t k;
+				if (pKeyElement->QueryUnsignedAttribute("time", &k.time) != XML_SUCCESS) return XML_ERROR_PARSING_ATTRIBUTE;
+				if (!r.vKeys.empty() && k.time < r.vKeys.back().time) return XML_ERROR_PARSING_ATTRIBUTE;
+				k.left = _HapticLevel(pKeyElement, "left");
+				k.right = _HapticLevel(pKeyElement, "right");
+				r.vKeys.push_back(k);
+
+				pKeyElement = pKeyElement->NextSiblingElement("Key");
+			}
+
+			pFile.vHaptics.push_back(r);
+
+			pHapticElement = pHapticElement->NextSiblingElement("Haptic");
 		}
 
 		return XML_SUCCESS;
 	}
 
-	// TODO: Create a way to write XML documents with registered actions.
-	/*
-	XMLError _WriteFile(const char* pszPath)
+	//-----------------------------------------------------------------------------
+	// Purpose: Resolve parsed binding names and modify the actions.
+	//-----------------------------------------------------------------------------
+	void _ApplyActions(const actionfile_t& pFile)
 	{
-		return XML_NO_ATTRIBUTE;
+		for (std::vector<actionrecord_t>::const_iterator it = pFile.vActions.begin(); it != pFile.vActions.end(); ++it)
+		{
+			ModifyAction(it->name, RInput_KM::GetButtonIndex(it->key.c_str()), RInput_GamePad::GetButtonIndex(it->button.c_str()));
+		}
+
+		for (std::vector<lookrecord_t>::const_iterator it = pFile.vLooks.begin(); it != pFile.vLooks.end(); ++it)
+		{
+			lookconfig_t c = GetLookConfig(it->name);
+			if (it->iFields & LOOK_FIELD_SENSITIVITY) c.sensitivity = it->config.sensitivity;
+			if (it->iFields & LOOK_FIELD_ACCELERATION) c.acceleration = it->config.acceleration;
+			if (it->iFields & LOOK_FIELD_DPI) c.dpi = it->config.dpi;
+			if (it->iFields & LOOK_FIELD_STICKSPEED) c.stickspeed = it->config.stickspeed;
+			if (it->iFields & LOOK_FIELD_STICKCURVE) c.stickcurve = it->config.stickcurve;
+			if (it->iFields & LOOK_FIELD_PORT) c.port = it->config.port;
+			if (it->iFields & LOOK_FIELD_INVERT) c.bInvertY = it->config.bInvertY;
+			ModifyLook(it->name, c);
+		}
+
+		for (std::vector<hapticrecord_t>::const_iterator it = pFile.vHaptics.begin(); it != pFile.vHaptics.end(); ++it)
+		{
+			if (it->bEnvelope) RegisterHapticEnvelope(it->name, it->left, it->right, it->attack, it->sustain, it->decay);
+			else RegisterHaptic(it->name, &it->vKeys[0], (Uint16)it->vKeys.size(), it->bLoop);
+		}
 	}
-	*/
 
 	//-----------------------------------------------------------------------------
 	// Purpose: Bool function to call the xml phrasing.
 	//-----------------------------------------------------------------------------
 	bool LoadActionsFromFile(const char* pszPath)
 	{
-		XMLError e = _ReadFile(pszPath);
+		actionfile_t file;
+		XMLError e = _ReadFile(pszPath, file);
 		if (e != XML_SUCCESS)
 		{
 			printf("Error: Failed to modify actions from XML file! XML Error: %i.\n", e);
 			return false;
 		}
 
+		_ApplyActions(file);
 		return true;
 	}
 
 	//-----------------------------------------------------------------------------
-	// Purpose: Call each tick to make the gamepad stick control the mouse pos.
+	// Purpose: State shared between LoadActionsFromFileAsync and its worker.
+	// The worker only writes staged and then publishes status; the main
+	// thread only reads staged after seeing a non-pending status. Whichever
+	// of the worker and the main thread lets go of it last deletes it.
+	//-----------------------------------------------------------------------------
+	struct actionload_t
+	{
+		std::string path;
+		actionfile_t staged;
+		XMLError eResult;
+		std::atomic<int> status;
+		std::atomic<int> iRefs;
+		SDL_Thread* thread;
+	};
+
+	int _LoadThread(void* pData)
+	{
+		actionload_t* load = (actionload_t*)pData;
+		load->eResult = _ReadFile(load->path.c_str(), load->staged);
+		load->status.store(load->eResult == XML_SUCCESS ? LOAD_READY : LOAD_FAILED, std::memory_order_release);
+
+		// Cancelled while reading; nobody else will free it.
+		if (load->iRefs.fetch_sub(1, std::memory_order_acq_rel) == 1) delete load;
+		return 0;
+	}
+
+	//-----------------------------------------------------------------------------
+	// Purpose: Read and parse the bindings on a worker thread. Nothing is
+	// applied until CommitActionLoad() is called. Returns NULL on failure.
+	//-----------------------------------------------------------------------------
+	actionload_t* LoadActionsFromFileAsync(const char* pszPath)
+	{
+		actionload_t* load = new actionload_t;
+		load->path = pszPath;
+		load->eResult = XML_SUCCESS;
+		load->status.store(LOAD_PENDING);
+		load->iRefs.store(2);
+
+		load->thread = SDL_CreateThread(_LoadThread, "RInputLoad", load);
+		if (load->thread == NULL)
+		{
+			printf("Error: Failed to start load thread! SDL Error: %s\n", SDL_GetError());
+			delete load;
+			return NULL;
+		}
+
+		return load;
+	}
+
+	//-----------------------------------------------------------------------------
+	// Purpose: Non-blocking check of an async load.
+	//-----------------------------------------------------------------------------
+	LoadStatus_t PollActionLoad(const actionload_t* pLoad)
+	{
+		if (pLoad == NULL) return LOAD_FAILED;
+		return (LoadStatus_t)pLoad->status.load(std::memory_order_acquire);
+	}
+
+	//-----------------------------------------------------------------------------
+	// Purpose: Apply the staged bindings on the calling (main) thread and free
+	// the handle. Waits for the worker if it hasn't finished yet, so poll first
+	// if you can't afford a stall.
 	//-----------------------------------------------------------------------------
-	Uint32 lasttickmousemove = 0;
-	void UpdateGamePadStickAsMouse(const Sint32& pWhich, const Sint8& pAxis)
+	bool CommitActionLoad(actionload_t* pLoad)
 	{
-		float rsX, rsY;
+		if (pLoad == NULL) return false;
+
+		SDL_WaitThread(pLoad->thread, NULL);
 
-		if (pAxis == GAMEPAD_AXIS_LSTICK)
+		bool bSuccess = pLoad->eResult == XML_SUCCESS;
+		if (bSuccess)
 		{
-			rsX = RInput_GamePad::GetAxisFloat(pWhich, SDL_CONTROLLER_AXIS_LEFTX);
-			rsY = RInput_GamePad::GetAxisFloat(pWhich, SDL_CONTROLLER_AXIS_LEFTY);
+			_ApplyActions(pLoad->staged);
 		}
 		else
 		{
-			rsX = RInput_GamePad::GetAxisFloat(pWhich, SDL_CONTROLLER_AXIS_RIGHTX);
-			rsY = RInput_GamePad::GetAxisFloat(pWhich, SDL_CONTROLLER_AXIS_RIGHTY);
+			printf("Error: Failed to modify actions from XML file! XML Error: %i.\n", pLoad->eResult);
 		}
 
-		if ((int)rsX != 0 || (int)rsY != 0)
+		delete pLoad;
+		return bSuccess;
+	}
+
+	//-----------------------------------------------------------------------------
+	// Purpose: Throw away a load without applying it and free the handle.
+	// Doesn't wait: a worker still reading is detached and frees the handle
+	// itself when it's done.
+	//-----------------------------------------------------------------------------
+	void CancelActionLoad(actionload_t* pLoad)
+	{
+		if (pLoad == NULL) return;
+
+		SDL_DetachThread(pLoad->thread);
+		if (pLoad->iRefs.fetch_sub(1, std::memory_order_acq_rel) == 1) delete pLoad;
+	}
+
+	typedef struct
+	{
+		std::string path;
+		actionfile_t file;
+		SaveCallback_t pCallback;
+		void* pUserData;
+
+	} savejob_t;
+
+	// The printer's buffer is kept between saves so repeated rebinds don't
+	// reallocate. Only touched by the save worker while holding save_mutex.
+	XMLPrinter save_printer;
+	SDL_mutex* save_mutex = NULL;
+
+	//-----------------------------------------------------------------------------
+	// Purpose: Moves the temp file over the destination in one step.
+	//-----------------------------------------------------------------------------
+	bool _ReplaceFile(const char* pszFrom, const char* pszTo)
+	{
+#ifdef _WIN32
+		return MoveFileExA(pszFrom, pszTo, MOVEFILE_REPLACE_EXISTING | MOVEFILE_WRITE_THROUGH) != 0;
+#else
+		return rename(pszFrom, pszTo) == 0;
+#endif
+	}
+
+	//-----------------------------------------------------------------------------
+	// Purpose: Uses tinyxml2 to write the action snapshot in the same layout
+	// _ReadFile expects. The document goes to "<path>.tmp" first and is then
+	// renamed, so a crash mid-write never leaves a half written config.
+	//-----------------------------------------------------------------------------
+	XMLError _WriteFile(const char* pszPath, const actionfile_t& pFile)
+	{
+		save_printer.ClearBuffer();
+		save_printer.OpenElement("Root");
+		save_printer.OpenElement("ActionSet");
+		for (std::vector<actionrecord_t>::const_iterator it = pFile.vActions.begin(); it != pFile.vActions.end(); ++it)
 		{
-			if (SDL_GetTicks() > lasttickmousemove)
+			save_printer.OpenElement("Action");
+			save_printer.PushAttribute("name", it->name.c_str());
+			save_printer.PushAttribute("key", it->key.c_str());
+			save_printer.PushAttribute("button", it->button.c_str());
+			save_printer.CloseElement();
+		}
+		save_printer.CloseElement();
+		for (std::vector<lookrecord_t>::const_iterator it = pFile.vLooks.begin(); it != pFile.vLooks.end(); ++it)
+		{
+			save_printer.OpenElement("Look");
+			save_printer.PushAttribute("name", it->name.c_str());
+			save_printer.PushAttribute("sensitivity", it->config.sensitivity);
+			save_printer.PushAttribute("acceleration", it->config.acceleration);
+			save_printer.PushAttribute("dpi", it->config.dpi);
+			save_printer.PushAttribute("stickspeed", it->config.stickspeed);
+			save_printer.PushAttribute("stickcurve", it->config.stickcurve);
+			save_printer.PushAttribute("port", it->config.port);
+			save_printer.PushAttribute("invert", it->config.bInvertY);
+			save_printer.CloseElement();
+		}
+		for (std::vector<hapticrecord_t>::const_iterator it = pFile.vHaptics.begin(); it != pFile.vHaptics.end(); ++it)
+		{
+			save_printer.OpenElement("Haptic");
+			save_printer.PushAttribute("name", it->name.c_str());
+			save_printer.PushAttribute("loop", it->bLoop);
+			for (std::vector<haptickey_t>::const_iterator k = it->vKeys.begin(); k != it->vKeys.end(); ++k)
 			{
-				RInput_KM::ModMousePosition((int)rsX, (int)rsY, false);
-				lasttickmousemove = SDL_GetTicks();
+				save_printer.OpenElement("Key");
+				save_printer.PushAttribute("time", (unsigned)k->time);
+				save_printer.PushAttribute("left", (unsigned)k->left);
+				save_printer.PushAttribute("right", (unsigned)k->right);
+				save_printer.CloseElement();
 			}
+			save_printer.CloseElement();
 		}
+		save_printer.CloseElement();
+
+		std::string tmp(pszPath);
+		tmp += ".tmp";
+
+		FILE* fp = fopen(tmp.c_str(), "wb");
+		if (fp == NULL) return XML_ERROR_FILE_COULD_NOT_BE_OPENED;
+
+		// CStrSize() counts the terminating null.
+		size_t len = (size_t)save_printer.CStrSize() - 1;
+		bool bWritten = fwrite(save_printer.CStr(), 1, len, fp) == len;
+		bWritten = (fflush(fp) == 0) && bWritten;
+		bWritten = (fclose(fp) == 0) && bWritten;
+
+		if (!bWritten || !_ReplaceFile(tmp.c_str(), pszPath))
+		{
+			remove(tmp.c_str());
+			return XML_ERROR_FILE_COULD_NOT_BE_OPENED;
+		}
+
+		return XML_SUCCESS;
 	}
 
 	//-----------------------------------------------------------------------------
-	// Purpose: Send a rumble command to the controller.
+	// Purpose: Worker thread entry for SaveActionsToFile.
+	//-----------------------------------------------------------------------------
+	int _SaveThread(void* pData)
+	{
+		savejob_t* job = (savejob_t*)pData;
+
+		SDL_LockMutex(save_mutex);
+		XMLError e = _WriteFile(job->path.c_str(), job->file);
+		SDL_UnlockMutex(save_mutex);
+
+		if (e != XML_SUCCESS)
+		{
+			printf("Error: Failed to save actions to XML file '%s'! XML Error: %i.\n", job->path.c_str(), e);
+		}
+
+		if (job->pCallback != NULL)
+		{
+			job->pCallback(job->path.c_str(), e == XML_SUCCESS, job->pUserData);
+		}
+
+		delete job;
+		return 0;
+	}
+
+	//-----------------------------------------------------------------------------
+	// Purpose: Snapshot the registered actions and write them out on a worker
+	// thread. Returns false if the worker couldn't be started.
+	//-----------------------------------------------------------------------------
+	bool SaveActionsToFile(const char* pszPath, SaveCallback_t pCallback, void* pUserData)
+	{
+		if (save_mutex == NULL)
+		{
+			save_mutex = SDL_CreateMutex();
+			if (save_mutex == NULL)
+			{
+				printf("Error: Failed to create save mutex! SDL Error: %s\n", SDL_GetError());
+				return false;
+			}
+		}
+
+		savejob_t* job = new savejob_t;
+		job->path = pszPath;
+		job->pCallback = pCallback;
+		job->pUserData = pUserData;
+		job->file.vActions.reserve(rinput_context->mActions.size());
+
+		for (std::map<std::string, action_t>::const_iterator it = rinput_context->mActions.begin(); it != rinput_context->mActions.end(); ++it)
+		{
+			actionrecord_t r;
+			const char* pszKey = RInput_KM::GetButtonName(it->second.key);
+			const char* pszButton = RInput_GamePad::GetButtonName(it->second.button);
+			r.name = it->first;
+			r.key = pszKey != NULL ? pszKey : "";
+			r.button = pszButton != NULL ? pszButton : "";
+			job->file.vActions.push_back(r);
+		}
+
+		for (int i = 0; i < GetLookCount(); i++)
+		{
+			lookrecord_t r;
+			r.name = GetLookName(i);
+			r.config = GetLookConfig(r.name);
+			r.iFields = LOOK_FIELD_ALL;
+			job->file.vLooks.push_back(r);
+		}
+
+		// Patterns are saved as keyframes, envelopes included.
+		for (int i = 0; i < GetHapticCount(); i++)
+		{
+			const haptickey_t* pKeys;
+			hapticrecord_t r;
+			Uint16 iCount;
+			GetHapticKeys(i, pKeys, iCount, r.bLoop);
+			r.name = GetHapticName(i);
+			r.bEnvelope = false;
+			r.vKeys.assign(pKeys, pKeys + iCount);
+			job->file.vHaptics.push_back(r);
+		}
+
+		SDL_Thread* thread = SDL_CreateThread(_SaveThread, "RInputSave", job);
+		if (thread == NULL)
+		{
+			printf("Error: Failed to start save thread! SDL Error: %s\n", SDL_GetError());
+			delete job;
+			return false;
+		}
+
+		SDL_DetachThread(thread);
+		return true;
+	}
+
+	//-----------------------------------------------------------------------------
+	// Purpose: Rumble the controller. Goes through the effect mixer, so it
+	// adds to whatever else is playing instead of replacing it.
 	//-----------------------------------------------------------------------------
 	#ifndef RINPUT_NO_RUMBLE
 	void RumbleGamePad(const int pPort, Uint16 iLeftMotor, Uint16 iRightMotor, Uint32 iDuration)
 	{
 		if (GetActiveDevice() == CONTROLLER_GAMEPAD)
 		{
-			if (pPort == CONTROLLER_PORT_ALL)
-			{
-				for (int i = 0; i < GetGamePadCount(); i++)
-				{
-					SDL_GameControllerRumble(RInput_GamePad::GetDeviceFromPort((RInput_GamePad::GamePadIndex)i).controller, iLeftMotor, iRightMotor, iDuration);
-				}
-			}
-			else
-			{
-				SDL_GameControllerRumble(RInput_GamePad::GetDeviceFromPort((RInput_GamePad::GamePadIndex)pPort).controller, iLeftMotor, iRightMotor, iDuration);
-			}
+			PlayRumble(pPort, iLeftMotor, iRightMotor, iDuration);
 		}
 	}
 	#endif
@@ -41,16 +41,17 @@ SOFTWARE.
 #include <map>
 #include <string>
 
-extern SDL_Window* actioncontroller_window;
-extern SDL_Event actioncontroller_event;
-
 //-----------------------------------------------------------------------------
 // Namespace for Keyboard + Mouse.
 //-----------------------------------------------------------------------------
 namespace RInput_KM
 {
-	void SimulateButton(const Sint32& pKey, bool bDown);
+	void SimulateButton(const Sint32& pKey, bool bDown, const Uint32 iTimestamp = 0);
 	float ButtonDown(const Sint32& pKey);
+
+	// SDL tick of the key's last press/release, 0 if never.
+	Uint32 ButtonPressTime(const Sint32& pKey);
+	Uint32 ButtonReleaseTime(const Sint32& pKey);
 	
 	void ShowMouse();
 	void HideMouse();
@@ -60,6 +61,29 @@ namespace RInput_KM
 	void SimulateMouse(const int x, const int y);
 	int GetMouseX();
 	int GetMouseY();
+
+	// Mouse movement over the last frame, summed from the motion events.
+	void AddMouseMotion(const int xrel, const int yrel);
+	void UpdateMouseDelta(); // <- Called by RInput::Update.
+	void GetMouseDelta(int& x, int& y);
+	int GetMouseDeltaX();
+	int GetMouseDeltaY();
+	bool SetRelativeMouseMode(bool bEnable);
+	bool GetRelativeMouseMode();
+	// SDL button (SDL_BUTTON_LEFT...SDL_BUTTON_X2), also kept as a bitmask in
+	// SDL_BUTTON() layout. The buttons bind as MOUSE_BUTTON_LEFT...X2.
+	void SimulateMouseButton(const Uint8& pButton, bool bDown, const Uint32 iTimestamp = 0);
+	Uint32 GetMouseButtonMask();
+	bool MouseButtonDown(const Uint8& pButton);
+
+	// Wheel movement over the last frame. Every tick is kept, and the precise
+	// value keeps the fractions reported by high resolution wheels. The
+	// deltas need RInput::Update(); until it has run, OnMouseWheelUp/Down
+	// (and wheel bindings) fall back to latching the wheel until read.
+	void AddMouseWheel(const int y, const float fPreciseY);
+	void UpdateMouseWheel(); // <- Called by RInput::Update.
+	int GetMouseWheelDelta();
+	float GetMouseWheelDeltaPrecise();
 	void SetMouseWheelPosition(const int y);
 	bool OnMouseWheelUp();
 	bool OnMouseWheelDown();
@@ -97,7 +121,8 @@ namespace RInput_GamePad
 		SDL_GameController* controller;
 		const char* pszDeviceName;
 		bool bEnabled;
-		std::map<Uint8, bool> mControllerButtons;
+		bool bVirtual; // <- No device; driven by InjectInputs/QueueInput.
+		bool bButtons[SDL_CONTROLLER_BUTTON_MAX];
 
 	} gamepad_t;
 
@@ -105,27 +130,86 @@ namespace RInput_GamePad
 	void Disconnect(const Sint32& pWhich);
 
 	gamepad_t GetDeviceFromPort(const GamePadIndex& pPort);
+	bool IsPortLive(const Sint32& pWhich); // <- A pad is open, or the port is virtual.
 
 	// Digital input:
-	void SimulateButton(const Sint32& pWhich, const Uint8& pButton, bool bDown);
+	void SimulateButton(const Sint32& pWhich, const Uint8& pButton, bool bDown, const Uint32 iTimestamp = 0);
 
 	float ButtonDown(const Uint8& pButton, const GamePadIndex& iIndex = ENUM_GAMEPAD_ONE);
 
+	// SDL tick of the button's last press/release, 0 if never. Includes the
+	// trigger and stick 'fake' buttons.
+	Uint32 ButtonPressTime(const Uint8& pButton, const GamePadIndex& iIndex = ENUM_GAMEPAD_ONE);
+	Uint32 ButtonReleaseTime(const Uint8& pButton, const GamePadIndex& iIndex = ENUM_GAMEPAD_ONE);
+
 	const char* GetButtonName(const Uint8& pButton);
 	Uint8 GetButtonIndex(const char* pButton);
 
 	// Analog input:
-	void UpdateAxisMotions(const Sint32& pWhich, const Uint32& pAxis);
+	void UpdateAxisMotions(const Sint32& pWhich, const Uint32& pAxis, const Sint16& pValue, const Uint32 iTimestamp = 0);
 	Sint16 GetAxisValue(const Sint32& pWhich, const Uint32& pAxis, bool bFlip = false);
 	const float GetAxisFloat(const Sint32& pWhich, const Uint32& pAxis, bool bFlip = false);
+	Sint16 GetAxisRaw(const Sint32& pWhich, const Uint32& pAxis); // <- Last event value, no deadzone.
+	Sint16 ShapeAxis(Sint16 val, const Uint32& pAxis, bool bFlip = false);
+	float AxisToFloat(const Sint16& iValue);
+	int GetAxisButtonAxis(const Uint8& pButton);
+	float AxisButtonValue(const Uint8& pButton, const Sint16& iRaw); // <- What ButtonDown reports for a fake button.
+
+	// Q1.15 fixed-point versions (RINPUT_FIXED_ONE is 1.0), worked out from
+	// the raw axis in integer math so every machine gets the same bits.
+	// The curve is a whole power; 1 is linear.
+	Sint16 AxisToFixed(const Sint16& iValue);
+	Sint16 AxisButtonFixed(const Uint8& pButton, const Sint16& iRaw);
+	Sint16 ButtonDownFixed(const Uint8& pButton, const GamePadIndex& iIndex = ENUM_GAMEPAD_ONE);
+	void GetStickCurvedFixed(const Sint32& pWhich, const Sint8& pStick, const Uint8& iCurve, Sint16& x, Sint16& y);
+	void GetStickCurved(const Sint32& pWhich, const Sint8& pStick, const float& fCurve, float& x, float& y);
 
 	void Flush(const Sint32& pWhich);
 	void FlushAll();
+
+	// Lazy controller database: the file is mapped once and only indexed
+	// when a joystick shows up that SDL has no mapping for.
+	bool OpenMappingDatabase(const char* pszPath);
+	void CloseMappingDatabase();
+	bool AddMappingForDevice(const Sint32& pWhich);
 }
 
 #define RUMBLE_MAX 65535
 #define RUMBLE_HALFMAX RUMBLE_MAX / 2
 
+// Effects that can overlap on one pad, and haptic patterns playing at once
+// across all pads.
+#define RUMBLE_MAX_EFFECTS 16
+#define HAPTIC_MAX_PLAYING 32
+
+// Extra bindings an action can hold on top of its key/button, and how many
+// inputs a single chord may combine. Stored inline in action_t.
+#define RINPUT_MAX_BINDINGS 4
+#define RINPUT_MAX_CHORD 3
+
+// Registered combos, and inputs remembered per player.
+#define COMBO_MAX 64
+#define COMBO_HISTORY 32
+
+// Gamepad buttons including the trigger and stick 'fake' ones, and the size
+// of the flat keyboard table (characters plus scancode keys).
+#define GAMEPAD_BUTTON_COUNT 26
+#define RINPUT_KEYSTATE_SIZE (128 + SDL_NUM_SCANCODES)
+
+// Actions carried in an input snapshot, and snapshots kept in flight so
+// readers never block the publisher.
+#define RINPUT_MAX_ACTIONS 128
+#define RINPUT_SNAPSHOT_BUFFERS 4
+
+// 1.0 in the Q1.15 fixed-point action values.
+#define RINPUT_FIXED_ONE 32767
+
+// Frames of input a rollback history keeps per player (power of two).
+#define RINPUT_HISTORY_FRAMES 128
+
+// Records QueueInput holds until the main thread drains them (power of two).
+#define RINPUT_INPUT_QUEUE_SIZE 1024
+
 //-----------------------------------------------------------------------------
 // The access point for the API. 
 //-----------------------------------------------------------------------------
@@ -140,6 +224,18 @@ namespace RInput
 	void Init(SDL_Window* pWindow);
 	void InitSDL(const void *data);
 
+	// All state lives in a context. The free functions work on the calling
+	// thread's current one, which starts out as a built-in default, so
+	// code that only needs one input stack never has to touch these.
+	// DestroyContext only moves the calling thread back to the default;
+	// switch every other thread using the context away first.
+	struct Context;
+	Context* CreateContext();
+	void DestroyContext(Context* pContext);
+	void SetCurrentContext(Context* pContext); // <- NULL for the default.
+	Context* GetCurrentContext();
+	SDL_Window* GetWindow();
+
 	void SetActiveDevice(const Controllers_t& pDevice);
 	Controllers_t GetActiveDevice();
 	const char* GetActiveDeviceAsString();
@@ -148,11 +244,54 @@ namespace RInput
 
 	void TestEvents(const SDL_Event& pEvent);
 	void PollEvents(); // <- Use this function if you're not using SDL event polling.
+	void Update(); // <- Call once a frame after TestEvents. PollEvents calls it for you.
+
+	// Pipeline counters for the last finished frame. Update() closes each
+	// frame and starts the next from zero.
+	typedef enum
+	{
+		INPUT_EVENTS_KEYBOARD,
+		INPUT_EVENTS_MOUSE,
+		INPUT_EVENTS_GAMEPAD,
+		INPUT_EVENTS_OTHER,
+		INPUT_EVENTS_MAX
+	} InputEventClass_t;
+
+	typedef struct
+	{
+		Uint32 iFrame;
+		Uint32 iEvents[INPUT_EVENTS_MAX]; // <- TestEvents calls by kind.
+		Uint32 iPollMicros; // <- PollEvents' event loop.
+		Uint32 iUpdateMicros; // <- Update: queue drain, evaluation, publishing.
+		Uint32 iSDLCalls; // <- Polls, axis reads, warps, rumble.
+		Uint32 iControllerUpdates; // <- SDL_GameControllerUpdate, also in iSDLCalls.
+		Uint32 iActionQueries; // <- Public action reads only, not the library's own.
+		Uint32 iQueueDropped; // <- QueueInput overflows.
+		Uint32 iSnapshotsDropped;
+
+	} inputcounters_t;
+
+	const inputcounters_t& GetInputCounters();
+
+	// Called from Update when poll + update time goes over iMicros; 0 turns
+	// the watchdog off.
+	typedef void (*BudgetCallback_t)(const inputcounters_t& pCounters, void* pUserData);
+	void SetInputBudget(const Uint32 iMicros, BudgetCallback_t pCallback, void* pUserData = NULL);
 
 	void Flush(const Controllers_t& pController);
 	void FlushAll();
 
 	//====================================================================
+	// An additional binding. Every input in the chord has to be held and
+	// the weakest one decides the value, e.g. Ctrl+S or A+RightShoulder.
+	typedef struct
+	{
+		Uint8 device; // Controllers_t
+		Uint8 count;
+		Sint32 inputs[RINPUT_MAX_CHORD];
+
+	} binding_t;
+
 	typedef struct
 	{
 		Sint32 key;
@@ -160,18 +299,367 @@ namespace RInput
 		bool bDown;
 		bool bHit;
 
+		// Checked along with key/button; the strongest input wins.
+		Uint8 iBindingCount;
+		binding_t bindings[RINPUT_MAX_BINDINGS];
+
+		// Press time taken by ConsumeBufferedPress.
+		Uint32 iConsumed;
+
+		// Index into the snapshot's action arrays.
+		Uint16 iSlot;
+
 	} action_t;
 
 	float GetActionInput(action_t& pButton);
+	float GetActionValue(const action_t& pButton);
+	Sint16 GetActionValueFixed(const action_t& pButton); // <- Q1.15, bit-identical everywhere.
+	Uint32 GetActionPressTime(const action_t& pAction);
+	Uint32 GetActionReleaseTime(const action_t& pAction);
 	void RegisterAction(const std::string& pActionName, Sint32 iKey, Uint8 iButton, bool bConistant);
 	void ModifyAction(const std::string& pActionName, Sint32 iKey, Uint8 iButton);
+	bool AddActionBinding(const std::string& pActionName, const Controllers_t& pDevice, const Sint32* pInputs, Uint8 iCount);
+	void ClearActionBindings(const std::string& pActionName);
 	action_t& GetAction(const std::string& pActionName);
+
+	// Input buffering, e.g. jump pressed just before landing. Uses the
+	// event timestamps, so the result doesn't depend on the frame rate.
+	bool WasPressedWithin(const action_t& pAction, const Uint32 iMs);
+	bool ConsumeBufferedPress(action_t& pAction, const Uint32 iMs);
 	bool LoadActionsFromFile(const char* pszPath);
 
-	void UpdateGamePadStickAsMouse(const Sint32& pWhich, const Sint8& pAxis);
+	typedef enum
+	{
+		LOAD_PENDING,
+		LOAD_READY,
+		LOAD_FAILED
+	} LoadStatus_t;
+
+	// Handle for a load running on a worker thread. Bindings are staged and
+	// only touch the action table when committed from the main thread.
+	// The caller owns the handle and must pass it to exactly one of
+	// CommitActionLoad or CancelActionLoad; both free it.
+	struct actionload_t;
+	actionload_t* LoadActionsFromFileAsync(const char* pszPath);
+	LoadStatus_t PollActionLoad(const actionload_t* pLoad);
+	bool CommitActionLoad(actionload_t* pLoad);
+	void CancelActionLoad(actionload_t* pLoad); // <- Doesn't block on the worker.
+
+	// Called from the save thread once the file is written (or failed).
+	typedef void (*SaveCallback_t)(const char* pszPath, bool bSuccess, void* pUserData);
+	bool SaveActionsToFile(const char* pszPath, SaveCallback_t pCallback = NULL, void* pUserData = NULL);
+
+	//====================================================================
+	// Save states: the whole input state (keys, buttons, axes, mouse, wheel,
+	// active device, action latches, interactions, look and cursor carry,
+	// combo progress) copied flat into a buffer. A state only loads into a
+	// context with the same actions, interactions and looks registered.
+	size_t GetStateSize();
+	size_t SaveState(void* pBuffer, const size_t iSize); // <- Bytes written, 0 if iSize is too small.
+	bool LoadState(const void* pBuffer, const size_t iSize);
+
+	//====================================================================
+	// Batch injection, for bots and load tests. Keys, mouse and gamepad
+	// buttons are down while value is non-zero; the wheel codes take ticks,
+	// INPUT_MOUSE_MOTION_X/Y and GAMEPAD_INPUT_AXIS() take the raw value.
+	// A timestamp of 0 means now.
+	typedef struct
+	{
+		Uint32 timestamp;
+		Sint32 code;
+		Sint16 value;
+		Uint8 device; // Controllers_t
+
+	} inputrecord_t;
+
+	// Gamepad records go to iPort. A port with no pad in it becomes a virtual
+	// one that keeps the injected buttons and axes, so bots and remote
+	// players work on a headless box. Returns how many records were applied.
+	size_t InjectInputs(const inputrecord_t* pRecords, const size_t iCount, const Sint32 iPort = 0);
+
+	// Safe from any thread using the same context: records are queued
+	// without locks and applied on the main thread, oldest timestamp first.
+	// TestEvents applies those stamped at or before each event it's given,
+	// so they merge with device input in time order; Update() (or PollEvents)
+	// applies whatever is left. Without either the queue fills up. Returns
+	// false, and counts it, when the queue is full.
+	bool QueueInput(const inputrecord_t& pRecord, const Sint32 iPort = 0);
+
+	typedef struct
+	{
+		Uint32 iQueued;
+		Uint32 iDropped; // <- Queue was full, or the record had a bad code or port.
+		Uint32 iHighWater; // <- Most records waiting to be applied at once.
+
+	} inputqueuestats_t;
+
+	inputqueuestats_t GetInputQueueStats();
+	void DrainInputQueue(); // <- Called by Update.
+
+	//====================================================================
+	// Input snapshots: an immutable copy of a frame's raw state and action
+	// values, published by Update(). Any thread using the same context can
+	// acquire the latest one without locks; release it when done so its
+	// buffer can be reused.
+	typedef struct
+	{
+		Uint32 iFrame;
+		Uint32 iTimestamp;
+		Uint8 device; // Controllers_t
+
+		bool bKeyState[RINPUT_KEYSTATE_SIZE];
+		Uint32 iMouseButtons;
+		int mouseX, mouseY;
+		int iMouseDeltaX, iMouseDeltaY;
+		int iWheelDelta;
+
+		bool bButtons[RInput_GamePad::ENUM_GAMEPAD_MAX + 1][GAMEPAD_BUTTON_COUNT];
+		Sint16 iAxes[RInput_GamePad::ENUM_GAMEPAD_MAX + 1][SDL_CONTROLLER_AXIS_MAX];
+
+		// By action slot; see GetActionSlot.
+		Uint16 iActionCount;
+		float fActions[RINPUT_MAX_ACTIONS];
+		Uint32 iActionPressTime[RINPUT_MAX_ACTIONS];
+
+	} inputsnapshot_t;
+
+	int GetActionSlot(const std::string& pActionName); // <- Main thread; the slot never changes.
+	void PublishSnapshot(); // <- Called by Update.
+	const inputsnapshot_t* AcquireSnapshot(); // <- NULL before the first publish.
+	void ReleaseSnapshot(const inputsnapshot_t* pSnapshot);
+	bool SnapshotKeyDown(const inputsnapshot_t* pSnapshot, const Sint32& pKey);
+	float SnapshotAction(const inputsnapshot_t* pSnapshot, const int iSlot);
+	Uint32 GetDroppedSnapshots(); // <- Publishes skipped because readers held every buffer.
+
+	//====================================================================
+	// Spectator streams: the raw device state of each frame as a diff
+	// against the frame before (changed keys and buttons, axes quantized to
+	// 8 bits), with a keyframe every iKeyframeInterval frames or on request
+	// so late joiners can sync. Records must arrive in order, e.g. over a
+	// file, pipe or TCP.
+	typedef struct
+	{
+		Uint32 iFrame;
+		bool bSynced; // <- A keyframe has been read; start zeroed.
+		Uint8 device; // Controllers_t
+		Uint32 iMouseButtons;
+		bool bKeyState[RINPUT_KEYSTATE_SIZE];
+		bool bButtons[RInput_GamePad::ENUM_GAMEPAD_MAX + 1][GAMEPAD_BUTTON_COUNT];
+		Sint8 iAxes[RInput_GamePad::ENUM_GAMEPAD_MAX + 1][SDL_CONTROLLER_AXIS_MAX]; // <- Raw axis / 256.
+
+	} spectatorstate_t;
+
+	struct spectatorstream_t;
+	spectatorstream_t* CreateSpectatorStream(const Uint32 iKeyframeInterval = 120);
+	void DestroySpectatorStream(spectatorstream_t* pStream);
+	void RequestSpectatorKeyframe(spectatorstream_t* pStream);
+
+	// Returns the bytes written, or -1 if iSize is too small.
+	int WriteSpectatorFrame(spectatorstream_t* pStream, const inputsnapshot_t* pSnapshot, Uint8* pBuffer, const int iSize);
+
+	// Applies one record. Diffs are skipped (false) until a keyframe. Each
+	// diff names the frame it was written against, so a missing record
+	// unsyncs the state until the next keyframe.
+	bool ReadSpectatorFrame(spectatorstate_t& pState, const Uint8* pBuffer, const int iSize);
+
+	//====================================================================
+	// Network frames: action values by slot, bit-packed and delta coded
+	// against a frame the other side has acknowledged. Actions are digital
+	// (1 bit) unless given more bits, which quantize -1..1 with 0 and the
+	// ends kept exact. Both ends need the same actions and bits.
+	typedef struct
+	{
+		Uint32 iFrame;
+		Uint16 iActionCount;
+		float fActions[RINPUT_MAX_ACTIONS];
+
+	} inputframe_t;
+
+	void SetActionFrameBits(const int iSlot, const Uint8 iBits); // <- 1 (digital) to 16.
+	void CaptureFrame(inputframe_t& pFrame, const Uint32 iFrame);
+
+	// Returns the bytes written, or -1 if iSize is too small. pBaseline may
+	// be NULL for a full frame.
+	int EncodeFrame(const inputframe_t& pFrame, const inputframe_t* pBaseline, Uint8* pBuffer, const int iSize);
+	bool DecodeFrame(const Uint8* pBuffer, const int iSize, const inputframe_t* pBaseline, inputframe_t& pFrame);
+
+	//====================================================================
+	// Rollback history: each player's frames (from CaptureFrame or
+	// DecodeFrame) keyed by simulation frame. Frames without real input yet
+	// are predicted by repeating the player's last one. When real input
+	// disagrees with a prediction that was handed out, the rollback frame is
+	// moved back to it; frames that were predicted right cost nothing.
+	struct inputhistory_t;
+	inputhistory_t* CreateInputHistory(const int iPlayers);
+	void DestroyInputHistory(inputhistory_t* pHistory);
+
+	bool AddHistoryInput(inputhistory_t* pHistory, const int iPlayer, const inputframe_t& pFrame); // <- False if too old to keep.
+	const inputframe_t* GetHistoryInput(inputhistory_t* pHistory, const int iPlayer, const Uint32 iFrame); // <- Real or predicted.
+	bool IsHistoryInputConfirmed(const inputhistory_t* pHistory, const int iPlayer, const Uint32 iFrame);
+	Uint32 GetHistoryChecksum(const inputhistory_t* pHistory, const Uint32 iFrame); // <- Every player's input for the frame.
+
+	// Earliest frame to resimulate from, if any prediction was wrong since
+	// the last ClearRollback.
+	bool GetRollbackFrame(const inputhistory_t* pHistory, Uint32& iFrame);
+	void ClearRollback(inputhistory_t* pHistory);
+
+	//====================================================================
+	// Headless sessions: input state for many simulated players (bots,
+	// remote players) on a server, with no window or devices. State and
+	// results are kept in per-field columns and evaluated in chunks on a
+	// worker pool, using the same binding rules as GetActionInput. Actions
+	// are addressed by their GetActionSlot.
+	struct sessionpool_t;
+	sessionpool_t* CreateSessionPool(const int iSessions, int iThreads = 0); // <- 0 uses every core.
+	void DestroySessionPool(sessionpool_t* pPool);
+	void CompileSessionActions(sessionpool_t* pPool); // <- After actions or bindings change.
+	int GetSessionCount(const sessionpool_t* pPool);
+
+	void ResetSession(sessionpool_t* pPool, const int iSession);
+	void SetSessionDevice(sessionpool_t* pPool, const int iSession, const Controllers_t& pDevice);
+	void SetSessionKey(sessionpool_t* pPool, const int iSession, const Sint32& pKey, bool bDown);
+	void SetSessionButton(sessionpool_t* pPool, const int iSession, const Uint8& pButton, bool bDown);
+	void SetSessionAxis(sessionpool_t* pPool, const int iSession, const Uint32& pAxis, const Sint16& iValue);
+	size_t InjectSessionInputs(sessionpool_t* pPool, const int iSession, const inputrecord_t* pRecords, const size_t iCount);
+
+	void UpdateSessions(sessionpool_t* pPool); // <- Once a server tick.
+	float GetSessionAction(const sessionpool_t* pPool, const int iSession, const int iSlot);
+	float GetSessionActionValue(const sessionpool_t* pPool, const int iSession, const int iSlot);
+	const float* GetSessionActionColumn(const sessionpool_t* pPool, const int iSlot);
+
+	//====================================================================
+	// Interactions: timing rules layered on an action, stepped by each
+	// button event as it arrives; Update() handles holds and polled input.
+	typedef enum
+	{
+		INTERACTION_TAP,				// Released before iMs.
+		INTERACTION_HOLD,				// Held for iMs; active until released.
+		INTERACTION_DOUBLETAP,			// Pressed twice within iMs.
+		INTERACTION_RELEASEAFTERHOLD,	// Released after being held for iMs.
+		INTERACTION_TOGGLE				// Each press flips it on or off.
+	} Interaction_t;
+
+	int AddInteraction(const std::string& pActionName, const Interaction_t& pType, const Uint32 iMs = 200);
+	bool OnInteraction(const int iInteraction); // <- True on the frame it happened.
+	bool GetInteractionActive(const int iInteraction); // <- Held past the hold time, or toggled on.
+	void UpdateInteractions(); // <- Called by Update.
+
+	//====================================================================
+	// Combos: motion inputs (numpad notation, 5 is neutral, 6 is forward),
+	// double taps and button sequences. Button steps name an action and
+	// match any key or button bound to it.
+	typedef enum
+	{
+		COMBO_STEP_DIRECTION,
+		COMBO_STEP_ACTION
+	} ComboStep_t;
+
+	typedef enum
+	{
+		COMBO_INPUT_DIRECTION,
+		COMBO_INPUT_KEY,
+		COMBO_INPUT_BUTTON
+	} ComboInput_t;
+
+	typedef struct
+	{
+		Uint8 type; // ComboStep_t
+		Uint8 direction;
+		const char* pszAction;
+
+	} combostep_t;
+
+	typedef struct
+	{
+		Uint32 timestamp;
+		Uint8 type; // ComboInput_t
+		Sint32 code;
+
+	} comboinput_t;
+
+	// iWindow is the most ms allowed between two steps. Returns -1 if another
+	// combo already has the same steps. Injected and queued input drives
+	// combos too; gamepad records go to the player matching their port.
+	int RegisterCombo(const std::string& pComboName, const combostep_t* pSteps, Uint8 iCount, Uint32 iWindow);
+	int GetComboIndex(const std::string& pComboName);
+	bool OnCombo(const int iCombo, const int iPlayer = 0);
+	void PushComboInput(const int iPlayer, Uint8 type, Sint32 code, Uint32 timestamp);
+	bool GetComboHistory(const int iPlayer, const Uint32 iAge, comboinput_t& pInput);
+	void SetComboFacing(const int iPlayer, bool bFlipped);
+	void SetComboDirectionKeys(Sint32 iUp, Sint32 iDown, Sint32 iLeft, Sint32 iRight);
+	void ComboTestEvent(const SDL_Event& pEvent); // <- Called by TestEvents.
+
+	//====================================================================
+	// Look: a 2D action read from the mouse delta, or a stick while the
+	// gamepad is active. Can be set per look in controller.xml.
+	typedef struct
+	{
+		float sensitivity;	// Output units per mouse count at 'dpi'.
+		float acceleration;	// Extra gain per count/ms of mouse speed.
+		float dpi;			// Mouse DPI; counts are normalized to 800.
+		float stickspeed;	// Output units per second at full tilt.
+		float stickcurve;	// Stick response exponent, 1 is linear.
+		Sint32 port;		// Gamepad port the stick is read from.
+		bool bInvertY;
+
+	} lookconfig_t;
+
+	int RegisterLook(const std::string& pLookName, const Sint8& pStick, const Sint32& pWhich = RInput_GamePad::ENUM_GAMEPAD_ONE); // <- GAMEPAD_AXIS_LSTICK or GAMEPAD_AXIS_RSTICK.
+	void ModifyLook(const std::string& pLookName, const lookconfig_t& pConfig);
+	int GetLookIndex(const std::string& pLookName);
+	lookconfig_t GetLookConfig(const std::string& pLookName);
+	int GetLookCount();
+	const char* GetLookName(const int iLook);
+	void GetLook(const int iLook, float& x, float& y);
+	void GetLookPixels(const int iLook, int& x, int& y); // <- Whole units; the fraction carries over.
+	void UpdateLooks(); // <- Called by Update.
+
+	//====================================================================
+	// Virtual cursor: moves the mouse with a stick at a speed that doesn't
+	// depend on the frame rate.
+	void EnableGamePadCursor(const Sint32& pWhich, const Sint8& pAxis);
+	void DisableGamePadCursor();
+	bool GetGamePadCursorEnabled();
+	void SetGamePadCursorSpeed(const float fSpeed, const float fCurve = 2.0f); // <- Pixels per second at full tilt.
+	void UpdateGamePadCursor(); // <- Called by Update.
+	void UpdateGamePadStickAsMouse(const Sint32& pWhich, const Sint8& pAxis); // <- Same as EnableGamePadCursor.
 	
 	#ifndef RINPUT_NO_RUMBLE
 	void RumbleGamePad(const int pPort = 0, Uint16 iLeftMotor = RUMBLE_MAX, Uint16 iRightMotor = RUMBLE_MAX, Uint32 iDuration = 1000);
+
+	// Rumble effects are mixed per pad (strongest per motor wins) and sent to
+	// SDL once a frame from Update(), only when the output changes. When a pad
+	// is full, the lowest priority effect makes room.
+	int PlayRumble(const int pPort, Uint16 iLeftMotor, Uint16 iRightMotor, Uint32 iDuration, Uint8 iPriority = 0);
+	void StopRumble(const int iEffect);
+	void StopAllRumble(const int pPort = -1); // <- -1 (CONTROLLER_PORT_ALL) for every pad.
+	void UpdateRumble(); // <- Called by Update.
+	#endif
+
+	//====================================================================
+	// Haptic patterns: keyframed motor levels (0 - RUMBLE_MAX), interpolated
+	// between keys. Loaded from <Haptic> elements in the bindings file or
+	// registered in code; played through the rumble mixer.
+	typedef struct
+	{
+		Uint32 time; // ms from the start.
+		Uint16 left;
+		Uint16 right;
+
+	} haptickey_t;
+
+	int RegisterHaptic(const std::string& pHapticName, const haptickey_t* pKeys, Uint16 iCount, bool bLoop);
+	int RegisterHapticEnvelope(const std::string& pHapticName, Uint16 iLeftMotor, Uint16 iRightMotor, Uint32 iAttack, Uint32 iSustain, Uint32 iDecay);
+	int GetHapticIndex(const std::string& pHapticName);
+	int GetHapticCount();
+	const char* GetHapticName(const int iHaptic);
+	bool GetHapticKeys(const int iHaptic, const haptickey_t*& pKeys, Uint16& iCount, bool& bLoop);
+
+	#ifndef RINPUT_NO_RUMBLE
+	int PlayHaptic(const int pPort, const int iHaptic, Uint8 iPriority = 0);
+	int PlayHaptic(const int pPort, const std::string& pHapticName, Uint8 iPriority = 0);
+	void StopHaptic(const int iPlaying);
+	void SampleHaptics(const Uint32 iNow, Uint16* pLeft, Uint16* pRight); // <- Called by UpdateRumble.
 	#endif
 }
 
@@ -304,6 +792,16 @@ namespace RInput
 #define MOUSE_BUTTON_WHEELDOWN MOUSE_BUTTON_WHEELUP + 1
 #define MOUSE_BUTTON_WHEELDOWN_NAME "mousewheeldown"
 
+// Side buttons:
+#define MOUSE_BUTTON_X1 MOUSE_BUTTON_WHEELDOWN + 1
+#define MOUSE_BUTTON_X2 MOUSE_BUTTON_X1 + 1
+#define MOUSE_BUTTON_X1_NAME "mousex1"
+#define MOUSE_BUTTON_X2_NAME "mousex2"
+
+// inputrecord_t codes for relative mouse movement, carried in the value.
+#define INPUT_MOUSE_MOTION_X -1
+#define INPUT_MOUSE_MOTION_Y -2
+
 // GamePad:
 #define GAMEPAD_BUTTON_A SDL_CONTROLLER_BUTTON_A
 #define GAMEPAD_BUTTON_B SDL_CONTROLLER_BUTTON_B
@@ -348,6 +846,9 @@ namespace RInput
 #define GAMEPAD_BUTTON_RSTICK_RIGHT 25
 #define GAMEPAD_BUTTON_RSTICK_RIGHT_NAME "rightstickright"
 
+// inputrecord_t code for a gamepad axis (SDL_CONTROLLER_AXIS_*).
+#define GAMEPAD_INPUT_AXIS(axis) (0x100 + (axis))
+
 #define CONTROLLER_PORT_ALL -1
 #define CONTROLLER_PORT_ONE RInput_GamePad::ENUM_GAMEPAD_ONE
 #define CONTROLLER_PORT_TWO RInput_GamePad::ENUM_GAMEPAD_TWO
@@ -0,0 +1,234 @@
+/*
+MIT License
+
+Copyright (c) 2019 Reep Softworks
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#include <vector>
+#include <string>
+#include <string.h>
+#include "rinput.h"
+#include "context.h"
+
+#define HISTORY_EMPTY 0
+#define HISTORY_PREDICTED 1
+#define HISTORY_CONFIRMED 2
+
+namespace RInput
+{
+	typedef struct
+	{
+		inputframe_t frame;
+		Uint32 iChecksum;
+		Uint8 state;
+
+	} historyslot_t;
+
+	typedef struct
+	{
+		historyslot_t slots[RINPUT_HISTORY_FRAMES];
+		Uint32 iLatest; // <- Newest confirmed frame.
+		bool bAny;
+
+	} historyplayer_t;
+
+	struct inputhistory_t
+	{
+		std::vector<historyplayer_t> vPlayers;
+		Uint32 iRollback;
+		bool bRollback;
+	};
+
+	//-----------------------------------------------------------------------------
+	// Purpose: FNV-1a over the frame's action values.
+	//-----------------------------------------------------------------------------
+	Uint32 _InputChecksum(const inputframe_t& pFrame)
+	{
+		Uint32 h = 2166136261u;
+		const Uint8* p = (const Uint8*)pFrame.fActions;
+		size_t n = pFrame.iActionCount * sizeof(float);
+		for (size_t i = 0; i < n; i++)
+		{
+			h = (h ^ p[i]) * 16777619u;
+		}
+
+		return h ^ pFrame.iActionCount;
+	}
+
+	//-----------------------------------------------------------------------------
+	// Purpose: Do two frames hold the same action values? Actions past the
+	// end of the shorter frame read as zero, like _FrameAction.
+	//-----------------------------------------------------------------------------
+	bool _SameInput(const inputframe_t& a, const inputframe_t& b)
+	{
+		int count = a.iActionCount > b.iActionCount ? a.iActionCount : b.iActionCount;
+		for (int i = 0; i < count; i++)
+		{
+			float fA = i < a.iActionCount ? a.fActions[i] : 0.0f;
+			float fB = i < b.iActionCount ? b.fActions[i] : 0.0f;
+			if (fA != fB) return false;
+		}
+
+		return true;
+	}
+
+	historyslot_t* _HistorySlot(const inputhistory_t* pHistory, const int iPlayer, const Uint32 iFrame)
+	{
+		if (pHistory == NULL || iPlayer < 0 || iPlayer >= (int)pHistory->vPlayers.size()) return NULL;
+		return (historyslot_t*)&pHistory->vPlayers[iPlayer].slots[iFrame & (RINPUT_HISTORY_FRAMES - 1)];
+	}
+
+	inputhistory_t* CreateInputHistory(const int iPlayers)
+	{
+		if (iPlayers <= 0) return NULL;
+
+		inputhistory_t* h = new inputhistory_t;
+		h->vPlayers.resize(iPlayers);
+		memset(&h->vPlayers[0], 0, iPlayers * sizeof(historyplayer_t));
+		h->iRollback = 0;
+		h->bRollback = false;
+		return h;
+	}
+
+	void DestroyInputHistory(inputhistory_t* pHistory)
+	{
+		delete pHistory;
+	}
+
+	//-----------------------------------------------------------------------------
+	// Purpose: Store a player's real input for pFrame.iFrame. If a different
+	// prediction was handed out for that frame, rollback has to start there.
+	//-----------------------------------------------------------------------------
+	bool AddHistoryInput(inputhistory_t* pHistory, const int iPlayer, const inputframe_t& pFrame)
+	{
+		historyslot_t* slot = _HistorySlot(pHistory, iPlayer, pFrame.iFrame);
+		if (slot == NULL) return false;
+
+		historyplayer_t& player = pHistory->vPlayers[iPlayer];
+		if (player.bAny && player.iLatest - pFrame.iFrame < 0x80000000u && player.iLatest - pFrame.iFrame >= RINPUT_HISTORY_FRAMES) return false;
+
+		bool bOurs = slot->state != HISTORY_EMPTY && slot->frame.iFrame == pFrame.iFrame;
+		if (bOurs && slot->state == HISTORY_PREDICTED && !_SameInput(slot->frame, pFrame))
+		{
+			if (!pHistory->bRollback || (Sint32)(pFrame.iFrame - pHistory->iRollback) < 0) pHistory->iRollback = pFrame.iFrame;
+			pHistory->bRollback = true;
+		}
+
+		slot->frame = pFrame;
+		slot->iChecksum = _InputChecksum(pFrame);
+		slot->state = HISTORY_CONFIRMED;
+
+		if (!player.bAny || (Sint32)(pFrame.iFrame - player.iLatest) > 0) player.iLatest = pFrame.iFrame;
+		player.bAny = true;
+		return true;
+	}
+
+	//-----------------------------------------------------------------------------
+	// Purpose: A player's input for a frame. Until the real input arrives
+	// this repeats the nearest earlier real input (or idle input), and
+	// remembers what it predicted.
+	//-----------------------------------------------------------------------------
+	const inputframe_t* GetHistoryInput(inputhistory_t* pHistory, const int iPlayer, const Uint32 iFrame)
+	{
+		historyslot_t* slot = _HistorySlot(pHistory, iPlayer, iFrame);
+		if (slot == NULL) return NULL;
+
+		if (slot->state == HISTORY_CONFIRMED && slot->frame.iFrame == iFrame) return &slot->frame;
+
+		// Usually the newest real input is the one to repeat; otherwise (input
+		// arriving out of order) look back for the nearest.
+		const historyslot_t* source = NULL;
+		const historyplayer_t& player = pHistory->vPlayers[iPlayer];
+		if (player.bAny && (Sint32)(iFrame - player.iLatest) > 0 && iFrame - player.iLatest < RINPUT_HISTORY_FRAMES)
+		{
+			source = _HistorySlot(pHistory, iPlayer, player.iLatest);
+		}
+
+		for (Uint32 back = 1; source == NULL && back < RINPUT_HISTORY_FRAMES; back++)
+		{
+			const historyslot_t* s = _HistorySlot(pHistory, iPlayer, iFrame - back);
+			if (s->state == HISTORY_CONFIRMED && s->frame.iFrame == iFrame - back)
+			{
+				source = s;
+				break;
+			}
+		}
+
+		if (source != NULL)
+		{
+			slot->frame.iActionCount = source->frame.iActionCount;
+			memcpy(slot->frame.fActions, source->frame.fActions, source->frame.iActionCount * sizeof(float));
+		}
+		else
+		{
+			// Nothing to repeat yet: predict every registered action idle, so
+			// the checksum matches a peer that has the real, idle frame.
+			size_t count = rinput_context->vActionSlots.size();
+			if (count > RINPUT_MAX_ACTIONS) count = RINPUT_MAX_ACTIONS;
+
+			slot->frame.iActionCount = (Uint16)count;
+			memset(slot->frame.fActions, 0, count * sizeof(float));
+		}
+
+		slot->frame.iFrame = iFrame;
+		slot->iChecksum = _InputChecksum(slot->frame);
+		slot->state = HISTORY_PREDICTED;
+		return &slot->frame;
+	}
+
+	bool IsHistoryInputConfirmed(const inputhistory_t* pHistory, const int iPlayer, const Uint32 iFrame)
+	{
+		const historyslot_t* slot = _HistorySlot(pHistory, iPlayer, iFrame);
+		return slot != NULL && slot->state == HISTORY_CONFIRMED && slot->frame.iFrame == iFrame;
+	}
+
+	//-----------------------------------------------------------------------------
+	// Purpose: Combined checksum of every player's input (real or predicted)
+	// for a frame, for comparing simulations between peers.
+	//-----------------------------------------------------------------------------
+	Uint32 GetHistoryChecksum(const inputhistory_t* pHistory, const Uint32 iFrame)
+	{
+		if (pHistory == NULL) return 0;
+
+		Uint32 h = 2166136261u;
+		for (size_t p = 0; p < pHistory->vPlayers.size(); p++)
+		{
+			const historyslot_t* slot = _HistorySlot(pHistory, (int)p, iFrame);
+			Uint32 c = (slot->state != HISTORY_EMPTY && slot->frame.iFrame == iFrame) ? slot->iChecksum : 0;
+			h = (h ^ c) * 16777619u;
+		}
+
+		return h;
+	}
+
+	bool GetRollbackFrame(const inputhistory_t* pHistory, Uint32& iFrame)
+	{
+		if (pHistory == NULL || !pHistory->bRollback) return false;
+
+		iFrame = pHistory->iRollback;
+		return true;
+	}
+
+	void ClearRollback(inputhistory_t* pHistory)
+	{
+		if (pHistory != NULL) pHistory->bRollback = false;
+	}
+}
@@ -0,0 +1,181 @@
+/*
+MIT License
+
+Copyright (c) 2019 Reep Softworks
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+
+#include "rinput.h"
+#include "context.h"
+
+#ifndef RINPUT_NO_RUMBLE
+
+// How long each motor command asks SDL to run for. The mix is re-sent
+// before this runs out, so a long effect doesn't stop early.
+#define RUMBLE_COMMAND_MS 1000
+#define RUMBLE_RESEND_MS (RUMBLE_COMMAND_MS / 2)
+
+namespace RInput
+{
+	//-----------------------------------------------------------------------------
+	// Purpose: Queue an effect on one pad. A full pad drops its lowest
+	// priority effect to make room, or refuses if they all outrank this one.
+	//-----------------------------------------------------------------------------
+	int _QueueRumble(const int pPort, Uint16 iLeftMotor, Uint16 iRightMotor, Uint32 iDuration, Uint8 iPriority, int id)
+	{
+		rumblepad_t& pad = rinput_context->rumble_pads[pPort];
+		Uint32 now = SDL_GetTicks();
+
+		int slot = -1;
+		for (int i = 0; i < RUMBLE_MAX_EFFECTS; i++)
+		{
+			rumbleeffect_t& e = pad.effects[i];
+			if (e.iEnd == 0 || (Sint32)(now - e.iEnd) >= 0)
+			{
+				slot = i;
+				break;
+			}
+
+			if (e.priority <= iPriority && (slot < 0 || e.priority < pad.effects[slot].priority))
+			{
+				slot = i;
+			}
+		}
+
+		if (slot < 0) return -1;
+
+		rumbleeffect_t& e = pad.effects[slot];
+		e.left = iLeftMotor;
+		e.right = iRightMotor;
+		e.priority = iPriority;
+		e.iEnd = now + iDuration;
+		if (e.iEnd == 0) e.iEnd = 1;
+		e.id = id;
+		return id;
+	}
+
+	//-----------------------------------------------------------------------------
+	// Purpose: Add an effect to the pad's mix. Nothing is sent to SDL until
+	// Update(). Returns a handle for StopRumble, or -1 if it was dropped.
+	//-----------------------------------------------------------------------------
+	int PlayRumble(const int pPort, Uint16 iLeftMotor, Uint16 iRightMotor, Uint32 iDuration, Uint8 iPriority)
+	{
+		int id = rinput_context->rumble_next_id++;
+		if (rinput_context->rumble_next_id < 0) rinput_context->rumble_next_id = 0;
+
+		if (pPort == CONTROLLER_PORT_ALL)
+		{
+			bool bQueued = false;
+			for (int i = 0; i <= RInput_GamePad::ENUM_GAMEPAD_MAX; i++)
+			{
+				if (_QueueRumble(i, iLeftMotor, iRightMotor, iDuration, iPriority, id) >= 0) bQueued = true;
+			}
+
+			return bQueued ? id : -1;
+		}
+
+		if (pPort < 0 || pPort > RInput_GamePad::ENUM_GAMEPAD_MAX) return -1;
+		return _QueueRumble(pPort, iLeftMotor, iRightMotor, iDuration, iPriority, id);
+	}
+
+	//-----------------------------------------------------------------------------
+	// Purpose: End an effect early, on every pad it was queued on.
+	//-----------------------------------------------------------------------------
+	void StopRumble(const int iEffect)
+	{
+		if (iEffect < 0) return;
+
+		for (int p = 0; p <= RInput_GamePad::ENUM_GAMEPAD_MAX; p++)
+		{
+			for (int i = 0; i < RUMBLE_MAX_EFFECTS; i++)
+			{
+				if (rinput_context->rumble_pads[p].effects[i].id == iEffect) rinput_context->rumble_pads[p].effects[i].iEnd = 0;
+			}
+		}
+	}
+
+	void StopAllRumble(const int pPort)
+	{
+		for (int p = 0; p <= RInput_GamePad::ENUM_GAMEPAD_MAX; p++)
+		{
+			if (pPort != CONTROLLER_PORT_ALL && pPort != p) continue;
+
+			for (int i = 0; i < RUMBLE_MAX_EFFECTS; i++)
+			{
+				rinput_context->rumble_pads[p].effects[i].iEnd = 0;
+			}
+		}
+	}
+
+	//-----------------------------------------------------------------------------
+	// Purpose: Mix each pad's effects and haptic patterns (strongest per
+	// motor wins) and send the result, but only when it changed or the last
+	// command is running out.
+	//-----------------------------------------------------------------------------
+	void UpdateRumble()
+	{
+		Uint32 now = SDL_GetTicks();
+
+		Uint16 mixLeft[RInput_GamePad::ENUM_GAMEPAD_MAX + 1] = { 0 };
+		Uint16 mixRight[RInput_GamePad::ENUM_GAMEPAD_MAX + 1] = { 0 };
+		SampleHaptics(now, mixLeft, mixRight);
+
+		for (int p = 0; p <= RInput_GamePad::ENUM_GAMEPAD_MAX; p++)
+		{
+			rumblepad_t& pad = rinput_context->rumble_pads[p];
+			Uint16 left = mixLeft[p];
+			Uint16 right = mixRight[p];
+
+			for (int i = 0; i < RUMBLE_MAX_EFFECTS; i++)
+			{
+				rumbleeffect_t& e = pad.effects[i];
+				if (e.iEnd == 0) continue;
+
+				if ((Sint32)(now - e.iEnd) >= 0)
+				{
+					e.iEnd = 0;
+					continue;
+				}
+
+				if (e.left > left) left = e.left;
+				if (e.right > right) right = e.right;
+			}
+
+			bool bChanged = left != pad.iSentLeft || right != pad.iSentRight;
+			bool bRunningOut = (left != 0 || right != 0) && now - pad.iSentTime >= RUMBLE_RESEND_MS;
+			if (!bChanged && !bRunningOut) continue;
+
+			// Only ports with a pad in them, wherever the other pads are.
+			SDL_GameController* controller = rinput_context->m_arrayControllers[p].controller;
+			if (controller != NULL)
+			{
+				SDL_GameControllerRumble(controller, left, right, (left != 0 || right != 0) ? RUMBLE_COMMAND_MS : 0);
+				RINPUT_COUNT(iSDLCalls);
+			}
+
+			pad.iSentLeft = left;
+			pad.iSentRight = right;
+			pad.iSentTime = now;
+		}
+	}
+}
+
+#endif // RINPUT_NO_RUMBLE
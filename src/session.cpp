@@ -0,0 +1,461 @@
+/*
+MIT License
+
+Copyright (c) 2019 Reep Softworks
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#include <vector>
+#include <string>
+#include <string.h>
+#include <atomic>
+#include "rinput.h"
+#include "context.h"
+
+// Sessions a worker takes at a time.
+#define SESSION_CHUNK 256
+
+namespace RInput
+{
+	//-----------------------------------------------------------------------------
+	// Purpose: An action with its keys already turned into key table slots,
+	// so evaluating it never looks anything up.
+	//-----------------------------------------------------------------------------
+	typedef struct
+	{
+		Sint32 key; // <- Key table slot, -1 if none.
+		Uint8 button;
+		bool bHit;
+		Uint8 iBindingCount;
+		binding_t bindings[RINPUT_MAX_BINDINGS];
+
+	} sessionaction_t;
+
+	struct sessionpool_t
+	{
+		int count;
+		std::vector<sessionaction_t> vActions;
+
+		// Raw state, a column per field.
+		std::vector<Uint8> vDevice;
+		std::vector<Uint8> vKeys; // <- RINPUT_KEYSTATE_SIZE per session.
+		std::vector<Uint32> vButtons; // <- Bit per real button.
+		std::vector<Sint16> vAxes[SDL_CONTROLLER_AXIS_MAX];
+
+		// Results, a column of count sessions per action.
+		std::vector<float> vValue;
+		std::vector<float> vInput;
+		std::vector<Uint8> vDown;
+
+		// Workers. The calling thread takes chunks too.
+		std::vector<SDL_Thread*> vThreads;
+		SDL_sem* start;
+		SDL_sem* done;
+		std::atomic<int> next;
+		std::atomic<bool> bQuit;
+	};
+
+	//-----------------------------------------------------------------------------
+	// Purpose: Key table slot for a key; the wheel and anything outside the
+	// table can't be held by a session.
+	//-----------------------------------------------------------------------------
+	Sint32 _SessionKey(const Sint32& pKey)
+	{
+		if (pKey == MOUSE_BUTTON_WHEELUP || pKey == MOUSE_BUTTON_WHEELDOWN) return -1;
+		return RInput_KM::_KeyStateIndex(pKey);
+	}
+
+	inline float _SessionInput(const sessionpool_t* pPool, const int s, const Uint8& pDevice, const Sint32& pInput)
+	{
+		if (pDevice == CONTROLLER_KEYBOARDMOUSE)
+		{
+			return (pInput >= 0) ? (float)pPool->vKeys[(size_t)s * RINPUT_KEYSTATE_SIZE + pInput] : 0.0f;
+		}
+
+		Uint8 b = (Uint8)pInput;
+		if (b < SDL_CONTROLLER_BUTTON_MAX) return (float)((pPool->vButtons[s] >> b) & 1);
+
+		int iAxis = RInput_GamePad::GetAxisButtonAxis(b);
+		return (iAxis >= 0) ? RInput_GamePad::AxisButtonValue(b, pPool->vAxes[iAxis][s]) : 0.0f;
+	}
+
+	//-----------------------------------------------------------------------------
+	// Purpose: GetActionValue for one session.
+	//-----------------------------------------------------------------------------
+	float _SessionActionValue(const sessionpool_t* pPool, const sessionaction_t& a, const int s)
+	{
+		float t = 0.0f;
+		Uint8 device = pPool->vDevice[s];
+
+		if (device == CONTROLLER_KEYBOARDMOUSE)
+		{
+			t = _SessionInput(pPool, s, device, a.key);
+		}
+		else if (device == CONTROLLER_GAMEPAD)
+		{
+			t = _SessionInput(pPool, s, device, (Sint32)a.button);
+		}
+
+		for (Uint8 i = 0; i < a.iBindingCount; i++)
+		{
+			const binding_t& b = a.bindings[i];
+			if (b.device != device) continue;
+
+			float v = 1.0f;
+			for (Uint8 j = 0; j < b.count && v > 0.0f; j++)
+			{
+				float c = _SessionInput(pPool, s, device, b.inputs[j]);
+				if (c < v) v = c;
+			}
+
+			if (v > t) t = v;
+		}
+
+		return t;
+	}
+
+	//-----------------------------------------------------------------------------
+	// Purpose: Evaluate every action for a run of sessions, applying the
+	// hit-once latch the same way GetActionInput does.
+	//-----------------------------------------------------------------------------
+	void _EvaluateSessions(sessionpool_t* pPool, const int iFirst, const int iLast)
+	{
+		for (size_t a = 0; a < pPool->vActions.size(); a++)
+		{
+			const sessionaction_t& action = pPool->vActions[a];
+			size_t column = a * (size_t)pPool->count;
+			float* value = &pPool->vValue[column];
+			float* input = &pPool->vInput[column];
+			Uint8* down = &pPool->vDown[column];
+
+			for (int s = iFirst; s < iLast; s++)
+			{
+				float t = _SessionActionValue(pPool, action, s);
+				value[s] = t;
+
+				if (t > 0.0f)
+				{
+					if (action.bHit)
+					{
+						if (down[s]) t = 0.0f;
+						down[s] = 1;
+					}
+				}
+				else
+				{
+					down[s] = 0;
+				}
+
+				input[s] = t;
+			}
+		}
+	}
+
+	void _RunSessionChunks(sessionpool_t* pPool)
+	{
+		for (;;)
+		{
+			int first = pPool->next.fetch_add(SESSION_CHUNK);
+			if (first >= pPool->count) return;
+
+			int last = first + SESSION_CHUNK;
+			if (last > pPool->count) last = pPool->count;
+			_EvaluateSessions(pPool, first, last);
+		}
+	}
+
+	int _SessionWorker(void* pData)
+	{
+		sessionpool_t* pool = (sessionpool_t*)pData;
+		for (;;)
+		{
+			SDL_SemWait(pool->start);
+			if (pool->bQuit) return 0;
+
+			_RunSessionChunks(pool);
+			SDL_SemPost(pool->done);
+		}
+	}
+
+	//-----------------------------------------------------------------------------
+	// Purpose: Create iSessions idle sessions, using the current context's
+	// actions. iThreads counts the caller; 0 uses every core.
+	//-----------------------------------------------------------------------------
+	sessionpool_t* CreateSessionPool(const int iSessions, int iThreads)
+	{
+		if (iSessions <= 0) return NULL;
+		if (iThreads <= 0) iThreads = SDL_GetCPUCount();
+
+		sessionpool_t* pool = new sessionpool_t();
+		pool->count = iSessions;
+		pool->vDevice.assign(iSessions, (Uint8)CONTROLLER_KEYBOARDMOUSE);
+		pool->vKeys.assign((size_t)iSessions * RINPUT_KEYSTATE_SIZE, 0);
+		pool->vButtons.assign(iSessions, 0);
+		for (int i = 0; i < SDL_CONTROLLER_AXIS_MAX; i++)
+		{
+			pool->vAxes[i].assign(iSessions, 0);
+		}
+
+		CompileSessionActions(pool);
+
+		pool->start = SDL_CreateSemaphore(0);
+		pool->done = SDL_CreateSemaphore(0);
+		pool->next = 0;
+		pool->bQuit = false;
+		if (pool->start == NULL || pool->done == NULL)
+		{
+			printf("Error: Failed to create session semaphores! SDL Error: %s\n", SDL_GetError());
+			iThreads = 1;
+		}
+
+		for (int i = 1; i < iThreads; i++)
+		{
+			SDL_Thread* t = SDL_CreateThread(_SessionWorker, "RInputSessions", pool);
+			if (t == NULL)
+			{
+				printf("Error: Failed to start session worker! SDL Error: %s\n", SDL_GetError());
+				break;
+			}
+			pool->vThreads.push_back(t);
+		}
+
+		return pool;
+	}
+
+	void DestroySessionPool(sessionpool_t* pPool)
+	{
+		if (pPool == NULL) return;
+
+		pPool->bQuit = true;
+		for (size_t i = 0; i < pPool->vThreads.size(); i++)
+		{
+			SDL_SemPost(pPool->start);
+		}
+
+		for (size_t i = 0; i < pPool->vThreads.size(); i++)
+		{
+			SDL_WaitThread(pPool->vThreads[i], NULL);
+		}
+
+		if (pPool->start) SDL_DestroySemaphore(pPool->start);
+		if (pPool->done) SDL_DestroySemaphore(pPool->done);
+		delete pPool;
+	}
+
+	//-----------------------------------------------------------------------------
+	// Purpose: Copy the current context's actions into the pool, by action
+	// slot. Call again after bindings change; existing results are kept.
+	//-----------------------------------------------------------------------------
+	void CompileSessionActions(sessionpool_t* pPool)
+	{
+		if (pPool == NULL) return;
+
+		const std::vector<action_t*>& slots = rinput_context->vActionSlots;
+		pPool->vActions.resize(slots.size());
+
+		for (size_t i = 0; i < slots.size(); i++)
+		{
+			const action_t& a = *slots[i];
+			sessionaction_t& c = pPool->vActions[i];
+			c.key = _SessionKey(a.key);
+			c.button = a.button;
+			c.bHit = a.bHit;
+			c.iBindingCount = a.iBindingCount;
+
+			for (Uint8 b = 0; b < a.iBindingCount; b++)
+			{
+				c.bindings[b] = a.bindings[b];
+				if (c.bindings[b].device != CONTROLLER_KEYBOARDMOUSE) continue;
+
+				for (Uint8 j = 0; j < c.bindings[b].count; j++)
+				{
+					c.bindings[b].inputs[j] = _SessionKey(c.bindings[b].inputs[j]);
+				}
+			}
+		}
+
+		size_t cells = slots.size() * (size_t)pPool->count;
+		pPool->vValue.resize(cells, 0.0f);
+		pPool->vInput.resize(cells, 0.0f);
+		pPool->vDown.resize(cells, 0);
+	}
+
+	int GetSessionCount(const sessionpool_t* pPool)
+	{
+		return pPool ? pPool->count : 0;
+	}
+
+	//-----------------------------------------------------------------------------
+	// Purpose: Let go of everything a session holds.
+	//-----------------------------------------------------------------------------
+	void ResetSession(sessionpool_t* pPool, const int iSession)
+	{
+		if (pPool == NULL || iSession < 0 || iSession >= pPool->count) return;
+
+		memset(&pPool->vKeys[(size_t)iSession * RINPUT_KEYSTATE_SIZE], 0, RINPUT_KEYSTATE_SIZE);
+		pPool->vButtons[iSession] = 0;
+		for (int i = 0; i < SDL_CONTROLLER_AXIS_MAX; i++)
+		{
+			pPool->vAxes[i][iSession] = 0;
+		}
+
+		for (size_t a = 0; a < pPool->vActions.size(); a++)
+		{
+			pPool->vDown[a * (size_t)pPool->count + iSession] = 0;
+		}
+	}
+
+	void SetSessionDevice(sessionpool_t* pPool, const int iSession, const Controllers_t& pDevice)
+	{
+		if (pPool == NULL || iSession < 0 || iSession >= pPool->count) return;
+		pPool->vDevice[iSession] = (Uint8)pDevice;
+	}
+
+	void SetSessionKey(sessionpool_t* pPool, const int iSession, const Sint32& pKey, bool bDown)
+	{
+		if (pPool == NULL || iSession < 0 || iSession >= pPool->count) return;
+
+		Sint32 i = _SessionKey(pKey);
+		if (i >= 0) pPool->vKeys[(size_t)iSession * RINPUT_KEYSTATE_SIZE + i] = bDown ? 1 : 0;
+	}
+
+	//-----------------------------------------------------------------------------
+	// Purpose: Set a real button. Trigger and stick buttons follow the axes.
+	//-----------------------------------------------------------------------------
+	void SetSessionButton(sessionpool_t* pPool, const int iSession, const Uint8& pButton, bool bDown)
+	{
+		if (pPool == NULL || iSession < 0 || iSession >= pPool->count || pButton >= SDL_CONTROLLER_BUTTON_MAX) return;
+
+		if (bDown) pPool->vButtons[iSession] |= (1u << pButton);
+		else pPool->vButtons[iSession] &= ~(1u << pButton);
+	}
+
+	void SetSessionAxis(sessionpool_t* pPool, const int iSession, const Uint32& pAxis, const Sint16& iValue)
+	{
+		if (pPool == NULL || iSession < 0 || iSession >= pPool->count || pAxis >= SDL_CONTROLLER_AXIS_MAX) return;
+		pPool->vAxes[pAxis][iSession] = iValue;
+	}
+
+	//-----------------------------------------------------------------------------
+	// Purpose: InjectInputs for one session. Sessions have no mouse or
+	// timestamps, so only keys, buttons and axes apply; the session's device
+	// follows the last of them.
+	//-----------------------------------------------------------------------------
+	size_t InjectSessionInputs(sessionpool_t* pPool, const int iSession, const inputrecord_t* pRecords, const size_t iCount)
+	{
+		if (pPool == NULL || iSession < 0 || iSession >= pPool->count || pRecords == NULL) return 0;
+
+		Uint8* keys = &pPool->vKeys[(size_t)iSession * RINPUT_KEYSTATE_SIZE];
+		Uint32 buttons = pPool->vButtons[iSession];
+		int device = -1;
+		size_t applied = 0;
+
+		for (size_t i = 0; i < iCount; i++)
+		{
+			const inputrecord_t& r = pRecords[i];
+
+			if (r.device == CONTROLLER_KEYBOARDMOUSE)
+			{
+				if (r.code < 0) continue;
+
+				Sint32 k = _SessionKey(r.code);
+				if (k < 0) continue;
+
+				keys[k] = r.value != 0 ? 1 : 0;
+			}
+			else if (r.device == CONTROLLER_GAMEPAD)
+			{
+				if (r.code >= GAMEPAD_INPUT_AXIS(0) && r.code < GAMEPAD_INPUT_AXIS(SDL_CONTROLLER_AXIS_MAX))
+				{
+					pPool->vAxes[r.code - GAMEPAD_INPUT_AXIS(0)][iSession] = r.value;
+				}
+				else if (r.code >= 0 && r.code < SDL_CONTROLLER_BUTTON_MAX)
+				{
+					if (r.value != 0) buttons |= (1u << r.code);
+					else buttons &= ~(1u << r.code);
+				}
+				else
+				{
+					continue;
+				}
+			}
+			else
+			{
+				continue;
+			}
+
+			device = r.device;
+			applied++;
+		}
+
+		pPool->vButtons[iSession] = buttons;
+		if (device >= 0) pPool->vDevice[iSession] = (Uint8)device;
+		return applied;
+	}
+
+	//-----------------------------------------------------------------------------
+	// Purpose: Evaluate every session's actions for the tick. Don't change
+	// session state while this runs.
+	//-----------------------------------------------------------------------------
+	void UpdateSessions(sessionpool_t* pPool)
+	{
+		if (pPool == NULL) return;
+
+		pPool->next = 0;
+		for (size_t i = 0; i < pPool->vThreads.size(); i++)
+		{
+			SDL_SemPost(pPool->start);
+		}
+
+		_RunSessionChunks(pPool);
+
+		for (size_t i = 0; i < pPool->vThreads.size(); i++)
+		{
+			SDL_SemWait(pPool->done);
+		}
+	}
+
+	//-----------------------------------------------------------------------------
+	// Purpose: This tick's results. GetSessionAction matches GetActionInput
+	// (hit-once actions report only their first tick), GetSessionActionValue
+	// matches GetActionValue.
+	//-----------------------------------------------------------------------------
+	float GetSessionAction(const sessionpool_t* pPool, const int iSession, const int iSlot)
+	{
+		if (pPool == NULL || iSession < 0 || iSession >= pPool->count || iSlot < 0 || iSlot >= (int)pPool->vActions.size()) return 0.0f;
+		return pPool->vInput[(size_t)iSlot * pPool->count + iSession];
+	}
+
+	float GetSessionActionValue(const sessionpool_t* pPool, const int iSession, const int iSlot)
+	{
+		if (pPool == NULL || iSession < 0 || iSession >= pPool->count || iSlot < 0 || iSlot >= (int)pPool->vActions.size()) return 0.0f;
+		return pPool->vValue[(size_t)iSlot * pPool->count + iSession];
+	}
+
+	//-----------------------------------------------------------------------------
+	// Purpose: Every session's GetSessionAction for one action, indexed by
+	// session. Valid until the next CompileSessionActions.
+	//-----------------------------------------------------------------------------
+	const float* GetSessionActionColumn(const sessionpool_t* pPool, const int iSlot)
+	{
+		if (pPool == NULL || iSlot < 0 || iSlot >= (int)pPool->vActions.size()) return NULL;
+		return &pPool->vInput[(size_t)iSlot * pPool->count];
+	}
+}
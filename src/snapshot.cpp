@@ -0,0 +1,153 @@
+/*
+MIT License
+
+Copyright (c) 2019 Reep Softworks
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#include <vector>
+#include <string>
+#include <string.h>
+#include "rinput.h"
+#include "context.h"
+
+namespace RInput
+{
+	//-----------------------------------------------------------------------------
+	// Purpose: Fill a snapshot from the current frame's state.
+	//-----------------------------------------------------------------------------
+	void _FillSnapshot(inputsnapshot_t& s)
+	{
+		s.iFrame = rinput_context->snapshot_frame;
+		s.iTimestamp = SDL_GetTicks();
+		s.device = (Uint8)rinput_context->active_device;
+
+		memcpy(s.bKeyState, rinput_context->bKeyState, sizeof(s.bKeyState));
+		s.iMouseButtons = rinput_context->iMouseButtons;
+		s.mouseX = rinput_context->mouseX;
+		s.mouseY = rinput_context->mouseY;
+		s.iMouseDeltaX = rinput_context->iMouseDeltaX;
+		s.iMouseDeltaY = rinput_context->iMouseDeltaY;
+		s.iWheelDelta = rinput_context->iWheelDelta;
+
+		for (int p = 0; p <= RInput_GamePad::ENUM_GAMEPAD_MAX; p++)
+		{
+			// Real buttons first, then the trigger and stick ones.
+			memcpy(s.bButtons[p], rinput_context->bAxisButtons[p], sizeof(s.bButtons[p]));
+			memcpy(s.bButtons[p], rinput_context->m_arrayControllers[p].bButtons, sizeof(rinput_context->m_arrayControllers[p].bButtons));
+			memcpy(s.iAxes[p], rinput_context->iAxisRaw[p], sizeof(s.iAxes[p]));
+		}
+
+		size_t count = rinput_context->vActionSlots.size();
+		if (count > RINPUT_MAX_ACTIONS) count = RINPUT_MAX_ACTIONS;
+		s.iActionCount = (Uint16)count;
+		for (size_t i = 0; i < count; i++)
+		{
+			const action_t& a = *rinput_context->vActionSlots[i];
+			s.fActions[i] = _ActionValue(a);
+			s.iActionPressTime[i] = _ActionPressTime(a);
+		}
+	}
+
+	//-----------------------------------------------------------------------------
+	// Purpose: Publish this frame's snapshot. Called by Update. The buffer
+	// written is one no reader holds, so readers never see it change.
+	//-----------------------------------------------------------------------------
+	void PublishSnapshot()
+	{
+		rinput_context->snapshot_frame++;
+
+		int latest = rinput_context->snapshot_latest.load(std::memory_order_relaxed) - 1;
+		int target = -1;
+		for (int i = 0; i < RINPUT_SNAPSHOT_BUFFERS; i++)
+		{
+			if (i == latest) continue;
+			if (rinput_context->snapshot_refs[i].load() == 0)
+			{
+				target = i;
+				break;
+			}
+		}
+
+		if (target < 0)
+		{
+			rinput_context->snapshot_dropped++;
+			return;
+		}
+
+		_FillSnapshot(rinput_context->snapshots[target]);
+		rinput_context->snapshot_latest.store(target + 1);
+	}
+
+	//-----------------------------------------------------------------------------
+	// Purpose: Take a reference to the latest snapshot. Safe from any thread
+	// whose current context is the publisher's, and the context must outlive
+	// the reference.
+	//-----------------------------------------------------------------------------
+	const inputsnapshot_t* AcquireSnapshot()
+	{
+		for (;;)
+		{
+			int i = rinput_context->snapshot_latest.load(std::memory_order_acquire) - 1;
+			if (i < 0) return NULL;
+
+			rinput_context->snapshot_refs[i].fetch_add(1);
+
+			// The publisher may have picked this buffer before our reference
+			// landed; only keep it if it's still the latest. Both sides use
+			// sequentially consistent ops so one of them sees the other.
+			if (rinput_context->snapshot_latest.load() - 1 == i)
+			{
+				return &rinput_context->snapshots[i];
+			}
+
+			rinput_context->snapshot_refs[i].fetch_sub(1, std::memory_order_release);
+		}
+	}
+
+	void ReleaseSnapshot(const inputsnapshot_t* pSnapshot)
+	{
+		if (!pSnapshot) return;
+
+		int i = (int)(pSnapshot - rinput_context->snapshots);
+		if (i < 0 || i >= RINPUT_SNAPSHOT_BUFFERS) return;
+
+		rinput_context->snapshot_refs[i].fetch_sub(1, std::memory_order_release);
+	}
+
+	bool SnapshotKeyDown(const inputsnapshot_t* pSnapshot, const Sint32& pKey)
+	{
+		if (!pSnapshot) return false;
+
+		int i = RInput_KM::_KeyStateIndex(pKey);
+		return (i >= 0) ? pSnapshot->bKeyState[i] : false;
+	}
+
+	float SnapshotAction(const inputsnapshot_t* pSnapshot, const int iSlot)
+	{
+		if (!pSnapshot || iSlot < 0 || iSlot >= pSnapshot->iActionCount) return 0.0f;
+		return pSnapshot->fActions[iSlot];
+	}
+
+	Uint32 GetDroppedSnapshots()
+	{
+		return rinput_context->snapshot_dropped;
+	}
+}
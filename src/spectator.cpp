@@ -0,0 +1,363 @@
+/*
+MIT License
+
+Copyright (c) 2019 Reep Softworks
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#include <vector>
+#include <string>
+#include <string.h>
+#include "rinput.h"
+#include "context.h"
+
+#define SPECTATOR_KEYFRAME	(1 << 0)
+#define SPECTATOR_DEVICE	(1 << 1)
+#define SPECTATOR_MOUSE		(1 << 2)
+
+#define SPECTATOR_PORTS (RInput_GamePad::ENUM_GAMEPAD_MAX + 1)
+
+namespace RInput
+{
+	struct spectatorstream_t
+	{
+		spectatorstate_t last;
+		Uint32 iInterval;
+		Uint32 iSinceKeyframe;
+		bool bKeyframe;
+	};
+
+	//-----------------------------------------------------------------------------
+	// Purpose: Byte writer/reader with LEB128 varints.
+	//-----------------------------------------------------------------------------
+	typedef struct
+	{
+		Uint8* p;
+		int iSize;
+		int iPos;
+		bool bOverflow;
+
+	} spectatorwriter_t;
+
+	typedef struct
+	{
+		const Uint8* p;
+		int iSize;
+		int iPos;
+		bool bOverflow;
+
+	} spectatorreader_t;
+
+	void _PutByte(spectatorwriter_t& w, const Uint8 v)
+	{
+		if (w.iPos >= w.iSize)
+		{
+			w.bOverflow = true;
+			return;
+		}
+
+		w.p[w.iPos++] = v;
+	}
+
+	void _PutVar(spectatorwriter_t& w, Uint32 v)
+	{
+		while (v >= 0x80)
+		{
+			_PutByte(w, (Uint8)(v | 0x80));
+			v >>= 7;
+		}
+		_PutByte(w, (Uint8)v);
+	}
+
+	Uint8 _GetByte(spectatorreader_t& r)
+	{
+		if (r.iPos >= r.iSize)
+		{
+			r.bOverflow = true;
+			return 0;
+		}
+
+		return r.p[r.iPos++];
+	}
+
+	Uint32 _GetVar(spectatorreader_t& r)
+	{
+		Uint32 v = 0;
+		for (int shift = 0; shift < 35; shift += 7)
+		{
+			Uint8 b = _GetByte(r);
+			v |= (Uint32)(b & 0x7F) << shift;
+			if (!(b & 0x80)) break;
+		}
+
+		return v;
+	}
+
+	//-----------------------------------------------------------------------------
+	// Purpose: The state a spectator sees, taken from a snapshot.
+	//-----------------------------------------------------------------------------
+	void _SpectatorFromSnapshot(spectatorstate_t& s, const inputsnapshot_t* pSnapshot)
+	{
+		s.iFrame = pSnapshot->iFrame;
+		s.bSynced = true;
+		s.device = pSnapshot->device;
+		s.iMouseButtons = pSnapshot->iMouseButtons;
+		memcpy(s.bKeyState, pSnapshot->bKeyState, sizeof(s.bKeyState));
+		memcpy(s.bButtons, pSnapshot->bButtons, sizeof(s.bButtons));
+
+		for (int p = 0; p < SPECTATOR_PORTS; p++)
+		{
+			for (int a = 0; a < SDL_CONTROLLER_AXIS_MAX; a++)
+			{
+				s.iAxes[p][a] = (Sint8)(pSnapshot->iAxes[p][a] >> 8);
+			}
+		}
+	}
+
+	spectatorstream_t* CreateSpectatorStream(const Uint32 iKeyframeInterval)
+	{
+		spectatorstream_t* s = new spectatorstream_t;
+		memset(&s->last, 0, sizeof(s->last));
+		s->iInterval = iKeyframeInterval;
+		s->iSinceKeyframe = 0;
+		s->bKeyframe = true;
+		return s;
+	}
+
+	void DestroySpectatorStream(spectatorstream_t* pStream)
+	{
+		delete pStream;
+	}
+
+	void RequestSpectatorKeyframe(spectatorstream_t* pStream)
+	{
+		if (pStream != NULL) pStream->bKeyframe = true;
+	}
+
+	//-----------------------------------------------------------------------------
+	// Purpose: Write the snapshot as a keyframe or a diff against the last
+	// frame written. A diff names that frame by its step back. Keys are sent
+	// as gaps between changed slots, buttons as one port/button byte, axes
+	// as a port/axis byte and the new value.
+	//-----------------------------------------------------------------------------
+	int WriteSpectatorFrame(spectatorstream_t* pStream, const inputsnapshot_t* pSnapshot, Uint8* pBuffer, const int iSize)
+	{
+		if (pStream == NULL || pSnapshot == NULL || pBuffer == NULL) return -1;
+
+		spectatorstate_t cur;
+		_SpectatorFromSnapshot(cur, pSnapshot);
+
+		bool bKeyframe = pStream->bKeyframe || (pStream->iInterval != 0 && pStream->iSinceKeyframe >= pStream->iInterval);
+		const spectatorstate_t& last = pStream->last;
+
+		Uint8 flags = 0;
+		if (bKeyframe) flags |= SPECTATOR_KEYFRAME | SPECTATOR_DEVICE | SPECTATOR_MOUSE;
+		if (cur.device != last.device) flags |= SPECTATOR_DEVICE;
+		if (cur.iMouseButtons != last.iMouseButtons) flags |= SPECTATOR_MOUSE;
+
+		spectatorwriter_t w = { pBuffer, iSize, 0, false };
+		_PutByte(w, flags);
+		_PutVar(w, cur.iFrame);
+		if (!bKeyframe) _PutVar(w, cur.iFrame - last.iFrame); // <- Snapshot frames can skip when a publish is dropped.
+		if (flags & SPECTATOR_DEVICE) _PutByte(w, cur.device);
+		if (flags & SPECTATOR_MOUSE) _PutVar(w, cur.iMouseButtons);
+
+		if (bKeyframe)
+		{
+			// Every slot as bits.
+			for (int i = 0; i < RINPUT_KEYSTATE_SIZE; i += 8)
+			{
+				Uint8 b = 0;
+				for (int j = 0; j < 8 && i + j < RINPUT_KEYSTATE_SIZE; j++)
+				{
+					if (cur.bKeyState[i + j]) b |= (Uint8)(1 << j);
+				}
+				_PutByte(w, b);
+			}
+
+			for (int p = 0; p < SPECTATOR_PORTS; p++)
+			{
+				Uint32 mask = 0;
+				for (int i = 0; i < GAMEPAD_BUTTON_COUNT; i++)
+				{
+					if (cur.bButtons[p][i]) mask |= (1u << i);
+				}
+				_PutVar(w, mask);
+
+				for (int a = 0; a < SDL_CONTROLLER_AXIS_MAX; a++)
+				{
+					_PutByte(w, (Uint8)cur.iAxes[p][a]);
+				}
+			}
+		}
+		else
+		{
+			Uint32 count = 0;
+			for (int i = 0; i < RINPUT_KEYSTATE_SIZE; i++)
+			{
+				if (cur.bKeyState[i] != last.bKeyState[i]) count++;
+			}
+			_PutVar(w, count);
+
+			int prev = 0;
+			for (int i = 0; i < RINPUT_KEYSTATE_SIZE; i++)
+			{
+				if (cur.bKeyState[i] == last.bKeyState[i]) continue;
+				_PutVar(w, (Uint32)(i - prev));
+				prev = i;
+			}
+
+			count = 0;
+			for (int p = 0; p < SPECTATOR_PORTS; p++)
+			{
+				for (int i = 0; i < GAMEPAD_BUTTON_COUNT; i++)
+				{
+					if (cur.bButtons[p][i] != last.bButtons[p][i]) count++;
+				}
+			}
+			_PutVar(w, count);
+
+			for (int p = 0; p < SPECTATOR_PORTS; p++)
+			{
+				for (int i = 0; i < GAMEPAD_BUTTON_COUNT; i++)
+				{
+					if (cur.bButtons[p][i] != last.bButtons[p][i]) _PutByte(w, (Uint8)((p << 5) | i));
+				}
+			}
+
+			count = 0;
+			for (int p = 0; p < SPECTATOR_PORTS; p++)
+			{
+				for (int a = 0; a < SDL_CONTROLLER_AXIS_MAX; a++)
+				{
+					if (cur.iAxes[p][a] != last.iAxes[p][a]) count++;
+				}
+			}
+			_PutVar(w, count);
+
+			for (int p = 0; p < SPECTATOR_PORTS; p++)
+			{
+				for (int a = 0; a < SDL_CONTROLLER_AXIS_MAX; a++)
+				{
+					if (cur.iAxes[p][a] == last.iAxes[p][a]) continue;
+					_PutByte(w, (Uint8)((p << 3) | a));
+					_PutByte(w, (Uint8)cur.iAxes[p][a]);
+				}
+			}
+		}
+
+		if (w.bOverflow) return -1;
+
+		pStream->last = cur;
+		pStream->bKeyframe = false;
+		pStream->iSinceKeyframe = bKeyframe ? 1 : pStream->iSinceKeyframe + 1;
+		return w.iPos;
+	}
+
+	//-----------------------------------------------------------------------------
+	// Purpose: Apply a record to a spectator's copy of the state. Works on a
+	// copy so a bad record leaves the state alone.
+	//-----------------------------------------------------------------------------
+	bool ReadSpectatorFrame(spectatorstate_t& pState, const Uint8* pBuffer, const int iSize)
+	{
+		if (pBuffer == NULL || iSize <= 0) return false;
+
+		spectatorreader_t r = { pBuffer, iSize, 0, false };
+		Uint8 flags = _GetByte(r);
+		Uint32 frame = _GetVar(r);
+
+		bool bKeyframe = (flags & SPECTATOR_KEYFRAME) != 0;
+		Uint32 step = bKeyframe ? 0 : _GetVar(r);
+		if (r.bOverflow) return false;
+
+		if (!bKeyframe && (!pState.bSynced || frame - step != pState.iFrame))
+		{
+			pState.bSynced = false;
+			return false;
+		}
+
+		spectatorstate_t s = pState;
+		s.iFrame = frame;
+		if (flags & SPECTATOR_DEVICE) s.device = _GetByte(r);
+		if (flags & SPECTATOR_MOUSE) s.iMouseButtons = _GetVar(r);
+
+		if (bKeyframe)
+		{
+			for (int i = 0; i < RINPUT_KEYSTATE_SIZE; i += 8)
+			{
+				Uint8 b = _GetByte(r);
+				for (int j = 0; j < 8 && i + j < RINPUT_KEYSTATE_SIZE; j++)
+				{
+					s.bKeyState[i + j] = (b >> j) & 1;
+				}
+			}
+
+			for (int p = 0; p < SPECTATOR_PORTS; p++)
+			{
+				Uint32 mask = _GetVar(r);
+				for (int i = 0; i < GAMEPAD_BUTTON_COUNT; i++)
+				{
+					s.bButtons[p][i] = (mask >> i) & 1;
+				}
+
+				for (int a = 0; a < SDL_CONTROLLER_AXIS_MAX; a++)
+				{
+					s.iAxes[p][a] = (Sint8)_GetByte(r);
+				}
+			}
+		}
+		else
+		{
+			Uint32 count = _GetVar(r);
+			Uint32 i = 0;
+			for (Uint32 n = 0; n < count && !r.bOverflow; n++)
+			{
+				i += _GetVar(r);
+				if (i >= RINPUT_KEYSTATE_SIZE) return false;
+				s.bKeyState[i] = !s.bKeyState[i];
+			}
+
+			count = _GetVar(r);
+			for (Uint32 n = 0; n < count && !r.bOverflow; n++)
+			{
+				Uint8 b = _GetByte(r);
+				int p = b >> 5, i = b & 31;
+				if (p >= SPECTATOR_PORTS || i >= GAMEPAD_BUTTON_COUNT) return false;
+				s.bButtons[p][i] = !s.bButtons[p][i];
+			}
+
+			count = _GetVar(r);
+			for (Uint32 n = 0; n < count && !r.bOverflow; n++)
+			{
+				Uint8 b = _GetByte(r);
+				int p = b >> 3, a = b & 7;
+				Sint8 v = (Sint8)_GetByte(r);
+				if (p >= SPECTATOR_PORTS || a >= SDL_CONTROLLER_AXIS_MAX) return false;
+				s.iAxes[p][a] = v;
+			}
+		}
+
+		if (r.bOverflow) return false;
+
+		s.bSynced = true;
+		pState = s;
+		return true;
+	}
+}
@@ -0,0 +1,247 @@
+/*
+MIT License
+
+Copyright (c) 2019 Reep Softworks
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#include <vector>
+#include <string>
+#include <string.h>
+#include "rinput.h"
+#include "context.h"
+
+// Bump STATE_VERSION whenever the layout below changes.
+#define STATE_MAGIC 0x54534952 // "RIST"
+#define STATE_VERSION 3
+
+namespace RInput
+{
+	typedef struct
+	{
+		Uint32 iMagic;
+		Uint32 iVersion;
+		Uint32 iSize;
+		Uint16 iActions;
+		Uint16 iInteractions;
+		Uint16 iLooks;
+		Uint16 iComboNodes; // <- combo_players holds indices into vComboNodes.
+
+	} stateheader_t;
+
+	//-----------------------------------------------------------------------------
+	// Purpose: Per-item state that sits next to pointers or strings in the
+	// context, so it's copied field by field.
+	//-----------------------------------------------------------------------------
+	typedef struct
+	{
+		Uint32 iConsumed;
+		bool bDown;
+
+	} stateaction_t;
+
+	typedef struct
+	{
+		Uint32 iSeen;
+		Uint32 iStart;
+		Uint32 iLastTap;
+		bool bHeld;
+		bool bFired;
+		bool bActive;
+		bool bTriggered;
+		bool bPending;
+
+	} stateinteraction_t;
+
+	typedef struct
+	{
+		float fRemainderX;
+		float fRemainderY;
+
+	} statelook_t;
+
+	typedef enum
+	{
+		STATE_MEASURE,
+		STATE_SAVE,
+		STATE_LOAD
+	} StateMode_t;
+
+	// Walks the layout; measuring, saving and loading share the one list so
+	// they can't drift apart.
+	typedef struct
+	{
+		Uint8* p;
+		size_t iOffset;
+		StateMode_t mode;
+
+	} statecursor_t;
+
+	inline void _StateField(statecursor_t& c, void* pField, const size_t iSize)
+	{
+		if (c.mode == STATE_SAVE) memcpy(c.p + c.iOffset, pField, iSize);
+		else if (c.mode == STATE_LOAD) memcpy(pField, c.p + c.iOffset, iSize);
+		c.iOffset += iSize;
+	}
+
+	#define STATE_FIELD(c, field) _StateField(c, &(field), sizeof(field))
+
+	void _StateWalk(statecursor_t& c)
+	{
+		Context* ctx = rinput_context;
+
+		STATE_FIELD(c, ctx->active_device);
+
+		STATE_FIELD(c, ctx->bKeyState);
+		STATE_FIELD(c, ctx->iKeyPressTime);
+		STATE_FIELD(c, ctx->iKeyReleaseTime);
+		STATE_FIELD(c, ctx->mouseX);
+		STATE_FIELD(c, ctx->mouseY);
+		STATE_FIELD(c, ctx->iMotionX);
+		STATE_FIELD(c, ctx->iMotionY);
+		STATE_FIELD(c, ctx->iMouseDeltaX);
+		STATE_FIELD(c, ctx->iMouseDeltaY);
+		STATE_FIELD(c, ctx->iMouseButtons);
+		STATE_FIELD(c, ctx->iWheelAccum);
+		STATE_FIELD(c, ctx->iWheelDelta);
+		STATE_FIELD(c, ctx->fWheelAccum);
+		STATE_FIELD(c, ctx->fWheelDelta);
+
+		for (int p = 0; p <= RInput_GamePad::ENUM_GAMEPAD_MAX; p++)
+		{
+			STATE_FIELD(c, ctx->m_arrayControllers[p].bButtons);
+		}
+		STATE_FIELD(c, ctx->bAxisButtons);
+		STATE_FIELD(c, ctx->iPressTime);
+		STATE_FIELD(c, ctx->iReleaseTime);
+		STATE_FIELD(c, ctx->iAxisRaw);
+
+		STATE_FIELD(c, ctx->combo_players);
+
+		STATE_FIELD(c, ctx->cursor_x);
+		STATE_FIELD(c, ctx->cursor_y);
+		STATE_FIELD(c, ctx->cursor_last_x);
+		STATE_FIELD(c, ctx->cursor_last_y);
+
+		for (size_t i = 0; i < ctx->vActionSlots.size(); i++)
+		{
+			action_t& a = *ctx->vActionSlots[i];
+			stateaction_t s;
+			memset(&s, 0, sizeof(s)); // <- Padding too, so equal states are equal bytes.
+			s.iConsumed = a.iConsumed;
+			s.bDown = a.bDown;
+			STATE_FIELD(c, s);
+			a.iConsumed = s.iConsumed;
+			a.bDown = s.bDown;
+		}
+
+		for (size_t i = 0; i < ctx->vInteractions.size(); i++)
+		{
+			interaction_t& it = ctx->vInteractions[i];
+			stateinteraction_t s;
+			memset(&s, 0, sizeof(s));
+			s.iSeen = it.iSeen;
+			s.iStart = it.iStart;
+			s.iLastTap = it.iLastTap;
+			s.bHeld = it.bHeld;
+			s.bFired = it.bFired;
+			s.bActive = it.bActive;
+			s.bTriggered = it.bTriggered;
+			s.bPending = it.bPending;
+			STATE_FIELD(c, s);
+			it.iSeen = s.iSeen;
+			it.iStart = s.iStart;
+			it.iLastTap = s.iLastTap;
+			it.bHeld = s.bHeld;
+			it.bFired = s.bFired;
+			it.bActive = s.bActive;
+			it.bTriggered = s.bTriggered;
+			it.bPending = s.bPending;
+		}
+
+		for (size_t i = 0; i < ctx->vLooks.size(); i++)
+		{
+			look_t& l = ctx->vLooks[i];
+			statelook_t s;
+			s.fRemainderX = l.fRemainderX;
+			s.fRemainderY = l.fRemainderY;
+			STATE_FIELD(c, s);
+			l.fRemainderX = s.fRemainderX;
+			l.fRemainderY = s.fRemainderY;
+		}
+	}
+
+	//-----------------------------------------------------------------------------
+	// Purpose: Bytes SaveState needs with what's registered now.
+	//-----------------------------------------------------------------------------
+	size_t GetStateSize()
+	{
+		statecursor_t c = { NULL, sizeof(stateheader_t), STATE_MEASURE };
+		_StateWalk(c);
+		return c.iOffset;
+	}
+
+	stateheader_t _StateHeader()
+	{
+		stateheader_t h;
+		h.iMagic = STATE_MAGIC;
+		h.iVersion = STATE_VERSION;
+		h.iSize = (Uint32)GetStateSize();
+		h.iActions = (Uint16)rinput_context->vActionSlots.size();
+		h.iInteractions = (Uint16)rinput_context->vInteractions.size();
+		h.iLooks = (Uint16)rinput_context->vLooks.size();
+		h.iComboNodes = (Uint16)rinput_context->vComboNodes.size();
+		return h;
+	}
+
+	size_t SaveState(void* pBuffer, const size_t iSize)
+	{
+		stateheader_t h = _StateHeader();
+		if (pBuffer == NULL || iSize < h.iSize) return 0;
+
+		memcpy(pBuffer, &h, sizeof(h));
+
+		statecursor_t c = { (Uint8*)pBuffer, sizeof(h), STATE_SAVE };
+		_StateWalk(c);
+		return h.iSize;
+	}
+
+	//-----------------------------------------------------------------------------
+	// Purpose: Restore a SaveState buffer. Nothing is touched unless the
+	// version and everything registered match.
+	//-----------------------------------------------------------------------------
+	bool LoadState(const void* pBuffer, const size_t iSize)
+	{
+		stateheader_t want = _StateHeader();
+		stateheader_t h;
+		if (pBuffer == NULL || iSize < sizeof(h)) return false;
+
+		memcpy(&h, pBuffer, sizeof(h));
+		if (memcmp(&h, &want, sizeof(h)) != 0 || iSize < h.iSize)
+		{
+			printf("Error: Input state doesn't match this build or its registered actions.\n");
+			return false;
+		}
+
+		statecursor_t c = { (Uint8*)pBuffer, sizeof(h), STATE_LOAD };
+		_StateWalk(c);
+		return true;
+	}
+}
@@ -1,8 +1,51 @@
 #include "rinput.h"
 
 #include <iostream>
+#include <vector>
+#include <string.h>
 
 bool quit = false;
+
+// Replay a spectator file written by the loop below: one spectator watches
+// from the start, another joins halfway and has to wait for a keyframe.
+void ReplaySpectatorFile(const char* path)
+{
+	FILE* f = fopen(path, "rb");
+	if (f == NULL) return;
+
+	std::vector<std::vector<Uint8> > records;
+	Uint16 len;
+	while (fread(&len, sizeof(len), 1, f) == 1)
+	{
+		std::vector<Uint8> record(len);
+		if (len == 0 || fread(&record[0], 1, len, f) != len) break;
+		records.push_back(record);
+	}
+	fclose(f);
+
+	RInput::spectatorstate_t full, late;
+	memset(&full, 0, sizeof(full));
+	memset(&late, 0, sizeof(late));
+
+	int fullApplied = 0, lateApplied = 0, lateSkipped = 0;
+	for (size_t i = 0; i < records.size(); i++)
+	{
+		if (RInput::ReadSpectatorFrame(full, &records[i][0], (int)records[i].size())) fullApplied++;
+
+		if (i < records.size() / 2) continue;
+		if (RInput::ReadSpectatorFrame(late, &records[i][0], (int)records[i].size())) lateApplied++;
+		else lateSkipped++;
+	}
+
+	bool bSame = late.bSynced && late.iFrame == full.iFrame
+		&& memcmp(late.bKeyState, full.bKeyState, sizeof(full.bKeyState)) == 0
+		&& memcmp(late.bButtons, full.bButtons, sizeof(full.bButtons)) == 0
+		&& memcmp(late.iAxes, full.iAxes, sizeof(full.iAxes)) == 0;
+
+	printf("Spectator replay: %d/%d records applied; late joiner skipped %d waiting for a keyframe, then applied %d and %s.\n",
+		fullApplied, (int)records.size(), lateSkipped, lateApplied, bSame ? "matches" : "does NOT match");
+}
+
 int main()
 {
 	SDL_Init(SDL_INIT_VIDEO);
@@ -31,8 +74,30 @@ int main()
 	RInput::RegisterAction("moveright", KEYBOARD_D, GAMEPAD_BUTTON_LSTICK_RIGHT, true);
 	RInput::RegisterAction("jump", KEYBOARD_SPACE, GAMEPAD_BUTTON_A, false);
 
+	// Jump can also be done by holding W and Up together.
+	Sint32 jumpchord[] = { KEYBOARD_W, KEYBOARD_UP };
+	RInput::AddActionBinding("jump", RInput::CONTROLLER_KEYBOARDMOUSE, jumpchord, 2);
+
+	// Mouse look, or the right stick on a gamepad. Tuned in controller.xml.
+	int look = RInput::RegisterLook("look", GAMEPAD_AXIS_RSTICK);
+
 	RInput::LoadActionsFromFile("controller.xml");
 
+	// Network frames: the stick driven moves are sent as 8 bit analog values.
+	const char* moves[] = { "moveforward", "movebackward", "moveleft", "moveright" };
+	for (int i = 0; i < 4; i++)
+	{
+		RInput::SetActionFrameBits(RInput::GetActionSlot(moves[i]), 8);
+	}
+
+	RInput::inputframe_t sent, received;
+	Uint32 iFrame = 0;
+	long iFrameBytes = 0;
+
+	// Spectator stream, written to a file with a length before each record.
+	RInput::spectatorstream_t* spectate = RInput::CreateSpectatorStream();
+	FILE* spectateFile = fopen("spectator.rin", "wb");
+
 	while (!quit)
 	{
 		while (SDL_PollEvent(&iEvent) != 0)
@@ -45,6 +110,8 @@ int main()
 			RInput::TestEvents(iEvent);
 		}
 
+		RInput::Update();
+
 		if (RInput::GetActionInput(RInput::GetAction("moveleft")))
 		{
 			printf("Moving Left!\n");
@@ -70,11 +137,52 @@ int main()
 			printf("Jump!\n");
 		}
 
+		int lookx, looky;
+		RInput::GetLookPixels(look, lookx, looky);
+		if (lookx != 0 || looky != 0)
+		{
+			printf("Looking %d %d\n", lookx, looky);
+		}
+
+		// Loopback of what a client would upload, each frame delta coded
+		// against the last one.
+		RInput::inputframe_t frame;
+		RInput::CaptureFrame(frame, ++iFrame);
+
+		Uint8 packet[64];
+		int bytes = RInput::EncodeFrame(frame, iFrame > 1 ? &sent : NULL, packet, sizeof(packet));
+		if (bytes > 0 && RInput::DecodeFrame(packet, bytes, iFrame > 1 ? &received : NULL, received))
+		{
+			sent = frame;
+			iFrameBytes += bytes;
+			if (bytes > 2) printf("Sent a %d byte frame\n", bytes);
+		}
+
+		const RInput::inputsnapshot_t* snapshot = RInput::AcquireSnapshot();
+		Uint8 record[512];
+		int recordBytes = RInput::WriteSpectatorFrame(spectate, snapshot, record, sizeof(record));
+		if (recordBytes > 0 && spectateFile != NULL)
+		{
+			Uint16 len = (Uint16)recordBytes;
+			fwrite(&len, sizeof(len), 1, spectateFile);
+			fwrite(record, 1, recordBytes, spectateFile);
+		}
+		RInput::ReleaseSnapshot(snapshot);
+
 		//TestKeyboard();
 		//TestMouse();
 		//TestGamePad();
 	}
 
+	if (iFrame > 0) printf("Network frames: %u sent, %.2f bytes each on average.\n", iFrame, (double)iFrameBytes / (double)iFrame);
+
+	if (spectateFile != NULL)
+	{
+		fclose(spectateFile);
+		ReplaySpectatorFile("spectator.rin");
+	}
+	RInput::DestroySpectatorStream(spectate);
+
 	SDL_DestroyWindow(window);
 	SDL_Quit();
 
@@ -0,0 +1,112 @@
+/*
+MIT License
+
+Copyright (c) 2019 Reep Softworks
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+
+// Benchmark: bandwidth of delta coded network input frames.
+//
+// Plays 6000 simulated frames of 8 digital and 4 analog (8 bit) actions
+// through EncodeFrame/DecodeFrame against the last acknowledged frame,
+// checks every decoded value and prints the average frame size.
+//
+// Usage: framebench [frames] [seed]
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <math.h>
+#include "rinput.h"
+
+#define BENCH_DIGITAL 8
+#define BENCH_ANALOG 4
+
+int main(int argc, char* argv[])
+{
+	int frames = (argc > 1) ? atoi(argv[1]) : 6000;
+	unsigned int seed = (argc > 2) ? (unsigned int)atoi(argv[2]) : 1;
+	if (frames < 2) frames = 2;
+
+	const char* names[BENCH_DIGITAL + BENCH_ANALOG] = { "fire", "jump", "crouch", "reload", "use", "sprint", "melee", "grenade", "movex", "movey", "lookx", "looky" };
+	int slots[BENCH_DIGITAL + BENCH_ANALOG];
+	for (int i = 0; i < BENCH_DIGITAL + BENCH_ANALOG; i++)
+	{
+		slots[i] = RInput::GetActionSlot(names[i]);
+		if (i >= BENCH_DIGITAL) RInput::SetActionFrameBits(slots[i], 8);
+	}
+
+	RInput::inputframe_t frame, sent, received, decoded;
+	frame.iFrame = 1;
+	frame.iActionCount = BENCH_DIGITAL + BENCH_ANALOG;
+	for (int i = 0; i < BENCH_DIGITAL + BENCH_ANALOG; i++) frame.fActions[slots[i]] = 0.0f;
+
+	Uint8 packet[600];
+	int bytes = RInput::EncodeFrame(frame, NULL, packet, sizeof(packet));
+	if (bytes < 0 || !RInput::DecodeFrame(packet, bytes, NULL, received))
+	{
+		printf("Error: The full frame didn't round trip.\n");
+		return 1;
+	}
+	sent = frame;
+
+	srand(seed);
+	long total = 0;
+	int errors = 0;
+	for (int f = 2; f <= frames; f++)
+	{
+		frame.iFrame = (Uint32)f;
+
+		// A button flips every 10 frames or so; an analog action moves every 3.
+		if (rand() % 10 == 0)
+		{
+			int k = slots[rand() % BENCH_DIGITAL];
+			frame.fActions[k] = frame.fActions[k] > 0.0f ? 0.0f : 1.0f;
+		}
+
+		if (rand() % 3 == 0)
+		{
+			int k = slots[BENCH_DIGITAL + rand() % BENCH_ANALOG];
+			frame.fActions[k] = (float)(rand() % 2001 - 1000) / 1000.0f;
+		}
+
+		bytes = RInput::EncodeFrame(frame, &sent, packet, sizeof(packet));
+		if (bytes < 0 || !RInput::DecodeFrame(packet, bytes, &received, decoded))
+		{
+			errors++;
+			continue;
+		}
+		total += bytes;
+
+		if (decoded.iFrame != frame.iFrame) errors++;
+		for (int i = 0; i < BENCH_DIGITAL + BENCH_ANALOG; i++)
+		{
+			float tolerance = (i >= BENCH_DIGITAL) ? 1.0f / 127.0f : 0.0f;
+			if (fabsf(decoded.fActions[slots[i]] - frame.fActions[slots[i]]) > tolerance) errors++;
+		}
+
+		sent = frame;
+		received = decoded;
+	}
+
+	double average = (double)total / (double)(frames - 1);
+	printf("%d frames, %d errors, %.2f bytes/frame, %.0f bits/s at 60 Hz\n", frames - 1, errors, average, average * 8.0 * 60.0);
+	return errors == 0 ? 0 : 1;
+}
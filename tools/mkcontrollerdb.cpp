@@ -0,0 +1,213 @@
+/*
+MIT License
+
+Copyright (c) 2019 Reep Softworks
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+// Build tool: turns gamecontrollerdb.txt into a GUID-sorted table that
+// src/controllerdb.cpp includes when RINPUT_EMBEDDED_GAMECONTROLLERDB is set.
+//
+// Usage: mkcontrollerdb <gamecontrollerdb.txt> <output.inc>
+
+#include <stdio.h>
+#include <string.h>
+#include <string>
+#include <vector>
+#include <algorithm>
+
+typedef struct
+{
+	unsigned char guid[16];
+	int platform;
+	size_t order;
+	std::string line;
+
+} entry_t;
+
+// Index 0 is for lines without a platform field.
+static const char* platforms[] = { "", "Windows", "Mac OS X", "Linux", "iOS", "Android" };
+static const int platform_count = sizeof(platforms) / sizeof(platforms[0]);
+
+//-----------------------------------------------------------------------------
+// Purpose: Converts the 32 hex characters at the start of a line.
+//-----------------------------------------------------------------------------
+static bool ParseGUID(const std::string& s, unsigned char* pGUID)
+{
+	if (s.size() < 32) return false;
+
+	for (int i = 0; i < 32; i++)
+	{
+		char c = s[i];
+		unsigned char n;
+		if (c >= '0' && c <= '9') n = (unsigned char)(c - '0');
+		else if (c >= 'a' && c <= 'f') n = (unsigned char)(c - 'a' + 10);
+		else if (c >= 'A' && c <= 'F') n = (unsigned char)(c - 'A' + 10);
+		else return false;
+
+		if (i & 1) pGUID[i / 2] |= n;
+		else pGUID[i / 2] = (unsigned char)(n << 4);
+	}
+
+	return true;
+}
+
+//-----------------------------------------------------------------------------
+// Purpose: Returns the platform index of a line, or -1 for unknown ones.
+//-----------------------------------------------------------------------------
+static int ParsePlatform(const std::string& s)
+{
+	size_t i = s.find("platform:");
+	if (i == std::string::npos) return 0;
+
+	i += 9;
+	size_t end = s.find(',', i);
+	std::string name = s.substr(i, end == std::string::npos ? std::string::npos : end - i);
+
+	for (int p = 1; p < platform_count; p++)
+	{
+		if (name == platforms[p]) return p;
+	}
+
+	return -1;
+}
+
+static bool EntryLess(const entry_t& a, const entry_t& b)
+{
+	int c = memcmp(a.guid, b.guid, sizeof(a.guid));
+	if (c != 0) return c < 0;
+	if (a.platform != b.platform) return a.platform < b.platform;
+	return a.order < b.order;
+}
+
+static bool SameKey(const entry_t& a, const entry_t& b)
+{
+	return memcmp(a.guid, b.guid, sizeof(a.guid)) == 0 && a.platform == b.platform;
+}
+
+//-----------------------------------------------------------------------------
+// Purpose: Strips the line ending and keeps the line if it's a mapping for
+// a known platform.
+//-----------------------------------------------------------------------------
+static void AddLine(std::vector<entry_t>& entries, std::string line)
+{
+	while (!line.empty() && (line[line.size() - 1] == '\n' || line[line.size() - 1] == '\r'))
+	{
+		line.erase(line.size() - 1);
+	}
+
+	entry_t e;
+	if (line.empty() || line[0] == '#' || !ParseGUID(line, e.guid)) return;
+
+	e.platform = ParsePlatform(line);
+	if (e.platform < 0) return;
+
+	e.order = entries.size();
+	e.line = line;
+	entries.push_back(e);
+}
+
+int main(int argc, char* argv[])
+{
+	if (argc != 3)
+	{
+		printf("Usage: %s <gamecontrollerdb.txt> <output.inc>\n", argv[0]);
+		return 1;
+	}
+
+	FILE* in = fopen(argv[1], "rb");
+	if (in == NULL)
+	{
+		printf("Error: Failed to open '%s'.\n", argv[1]);
+		return 1;
+	}
+
+	std::vector<entry_t> entries;
+	std::string line;
+	char buf[4096];
+	while (fgets(buf, sizeof(buf), in) != NULL)
+	{
+		line += buf;
+		if (line.empty() || line[line.size() - 1] != '\n') continue;
+
+		AddLine(entries, line);
+		line.clear();
+	}
+	fclose(in);
+
+	// The last line may not end in a newline.
+	if (!line.empty()) AddLine(entries, line);
+
+	// SDL lets later lines override earlier ones, so keep the last of each key.
+	std::sort(entries.begin(), entries.end(), EntryLess);
+	std::vector<entry_t> unique;
+	for (size_t i = 0; i < entries.size(); i++)
+	{
+		if (i + 1 < entries.size() && SameKey(entries[i], entries[i + 1])) continue;
+		unique.push_back(entries[i]);
+	}
+
+	if (unique.empty())
+	{
+		printf("Error: No mappings found in '%s'.\n", argv[1]);
+		return 1;
+	}
+
+	FILE* out = fopen(argv[2], "wb");
+	if (out == NULL)
+	{
+		printf("Error: Failed to open '%s' for writing.\n", argv[2]);
+		return 1;
+	}
+
+	fprintf(out, "// Generated by mkcontrollerdb from gamecontrollerdb.txt. Do not edit.\n\n");
+
+	fprintf(out, "static const char* const embedded_platforms[] =\n{\n");
+	for (int p = 0; p < platform_count; p++)
+	{
+		fprintf(out, "\t\"%s\",\n", platforms[p]);
+	}
+	fprintf(out, "};\n\n");
+
+	fprintf(out, "static const embeddedmapping_t embedded_mappings[] =\n{\n");
+	for (size_t i = 0; i < unique.size(); i++)
+	{
+		fprintf(out, "\t{ {");
+		for (int b = 0; b < 16; b++)
+		{
+			fprintf(out, "%s0x%02x", b ? "," : "", unique[i].guid[b]);
+		}
+		fprintf(out, "}, %d, \"", unique[i].platform);
+
+		for (size_t c = 0; c < unique[i].line.size(); c++)
+		{
+			unsigned char ch = (unsigned char)unique[i].line[c];
+			if (ch == '"' || ch == '\\') fprintf(out, "\\%c", ch);
+			else if (ch < 0x20 || ch >= 0x7f) fprintf(out, "\\%03o", ch);
+			else fputc(ch, out);
+		}
+		fprintf(out, "\" },\n");
+	}
+	fprintf(out, "};\n");
+
+	fclose(out);
+	printf("mkcontrollerdb: wrote %u mappings.\n", (unsigned)unique.size());
+	return 0;
+}